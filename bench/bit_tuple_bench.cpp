@@ -0,0 +1,215 @@
+/******************************************************************************
+
+  bit_tuple_bench.cpp
+
+  Throughput of bit_tuple pack, unpack, compare, and hash, against
+  std::tuple and hand-written shift/mask code on the same layout.
+
+  Usage: bit_tuple_bench [num_labels [repetitions]]
+
+  Build in Release mode (-O2 or higher) for meaningful results.
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/bit_tuple.h"
+#include "mcutils/profiling.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+typedef mcutils::bit_tuple<std::uint32_t,8,8,16> label_type;
+typedef std::tuple<int,int,int> tuple_type;
+
+// hand-written packing of the same layout
+inline std::uint32_t PackLabel(std::uint32_t n, std::uint32_t l, std::uint32_t m)
+{
+  return ((n&0xFFu)<<24) | ((l&0xFFu)<<16) | (m&0xFFFFu);
+}
+
+inline std::uint32_t LabelN(std::uint32_t label) { return label>>24; }
+inline std::uint32_t LabelL(std::uint32_t label) { return (label>>16)&0xFFu; }
+inline std::uint32_t LabelM(std::uint32_t label) { return label&0xFFFFu; }
+
+// prevent optimizer from discarding results
+volatile std::uint64_t sink;
+
+template<typename F>
+void Benchmark(const char* name, std::size_t num_labels, int repetitions, F f)
+// Time f() over repetitions, and report time per label.
+{
+  mcutils::SteadyTimer timer;
+  std::uint64_t checksum = 0;
+  timer.Start();
+  for (int r=0; r<repetitions; ++r)
+    checksum += f();
+  timer.Stop();
+  sink = checksum;
+  const double ns_per_label = 1e9*timer.ElapsedTime()/(double(num_labels)*repetitions);
+  std::printf("  %-28s %8.3f ns/label  (checksum %llu)\n",name,ns_per_label,(unsigned long long)(checksum));
+}
+
+int main(int argc, char **argv)
+{
+  const std::size_t num_labels = (argc>1) ? std::strtoull(argv[1],nullptr,10) : (1<<20);
+  const int repetitions = (argc>2) ? std::atoi(argv[2]) : 20;
+
+  // input columns
+  std::vector<std::uint32_t> n_column(num_labels), l_column(num_labels), m_column(num_labels);
+  std::uint32_t state = 12345;
+  for (std::size_t i=0; i<num_labels; ++i)
+    {
+      state = state*1664525u+1013904223u;
+      n_column[i] = (state>>24)&0xFFu;
+      l_column[i] = (state>>16)&0xFFu;
+      m_column[i] = state&0xFFFFu;
+    }
+
+  std::vector<label_type> bit_tuples(num_labels);
+  std::vector<tuple_type> tuples(num_labels);
+  std::vector<std::uint32_t> words(num_labels);
+
+  std::printf("bit_tuple_bench: %zu labels x %d repetitions\n",num_labels,repetitions);
+
+  ////////////////////////////////////////////////////////////////
+  // pack
+  ////////////////////////////////////////////////////////////////
+
+  std::printf("pack\n");
+  Benchmark("bit_tuple constructor",num_labels,repetitions,
+    [&]() {
+      for (std::size_t i=0; i<num_labels; ++i)
+        bit_tuples[i] = label_type(n_column[i],l_column[i],m_column[i]);
+      return std::uint64_t(bit_tuples[num_labels/2].bitrep());
+    });
+  Benchmark("bit_tuple pack_bit_tuple",num_labels,repetitions,
+    [&]() {
+      for (std::size_t i=0; i<num_labels; ++i)
+        bit_tuples[i] = mcutils::pack_bit_tuple<label_type>(std::make_tuple(n_column[i],l_column[i],m_column[i]));
+      return std::uint64_t(bit_tuples[num_labels/2].bitrep());
+    });
+  Benchmark("std::tuple",num_labels,repetitions,
+    [&]() {
+      for (std::size_t i=0; i<num_labels; ++i)
+        tuples[i] = tuple_type(n_column[i],l_column[i],m_column[i]);
+      return std::uint64_t(std::get<2>(tuples[num_labels/2]));
+    });
+  Benchmark("shift/mask",num_labels,repetitions,
+    [&]() {
+      for (std::size_t i=0; i<num_labels; ++i)
+        words[i] = PackLabel(n_column[i],l_column[i],m_column[i]);
+      return std::uint64_t(words[num_labels/2]);
+    });
+
+  ////////////////////////////////////////////////////////////////
+  // unpack
+  ////////////////////////////////////////////////////////////////
+
+  std::printf("unpack (sum of fields)\n");
+  Benchmark("bit_tuple get<>",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (const label_type& label : bit_tuples)
+        sum += std::uint32_t(mcutils::get<0>(label)) + std::uint32_t(mcutils::get<1>(label))
+          + std::uint32_t(mcutils::get<2>(label));
+      return sum;
+    });
+  Benchmark("bit_tuple unpack_bit_tuple",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (const label_type& label : bit_tuples)
+        {
+          const auto [n,l,m] = mcutils::unpack_bit_tuple(label);
+          sum += n+l+m;
+        }
+      return sum;
+    });
+  Benchmark("std::tuple",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (const tuple_type& tuple : tuples)
+        sum += std::uint32_t(std::get<0>(tuple)+std::get<1>(tuple)+std::get<2>(tuple));
+      return sum;
+    });
+  Benchmark("shift/mask",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (std::uint32_t word : words)
+        sum += LabelN(word)+LabelL(word)+LabelM(word);
+      return sum;
+    });
+
+  ////////////////////////////////////////////////////////////////
+  // compare
+  ////////////////////////////////////////////////////////////////
+
+  std::printf("compare (count of ordered neighbors)\n");
+  Benchmark("bit_tuple",num_labels,repetitions,
+    [&]() {
+      std::uint64_t count = 0;
+      for (std::size_t i=1; i<num_labels; ++i)
+        count += (bit_tuples[i-1].bitrep()<bit_tuples[i].bitrep());
+      return count;
+    });
+  Benchmark("std::tuple",num_labels,repetitions,
+    [&]() {
+      std::uint64_t count = 0;
+      for (std::size_t i=1; i<num_labels; ++i)
+        count += (tuples[i-1]<tuples[i]);
+      return count;
+    });
+  Benchmark("shift/mask",num_labels,repetitions,
+    [&]() {
+      std::uint64_t count = 0;
+      for (std::size_t i=1; i<num_labels; ++i)
+        count += (words[i-1]<words[i]);
+      return count;
+    });
+
+  ////////////////////////////////////////////////////////////////
+  // hash
+  ////////////////////////////////////////////////////////////////
+
+  std::printf("hash (sum of hashes)\n");
+  Benchmark("std::hash<bit_tuple>",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (const label_type& label : bit_tuples)
+        sum += std::hash<label_type>()(label);
+      return sum;
+    });
+  Benchmark("bit_tuple HashMix",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (const label_type& label : bit_tuples)
+        sum += mcutils::impl::hash_bit_tuple_word(label.bitrep());
+      return sum;
+    });
+  Benchmark("std::tuple (combined)",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (const tuple_type& tuple : tuples)
+        {
+          std::size_t h = std::hash<int>()(std::get<0>(tuple));
+          h = h*31 + std::hash<int>()(std::get<1>(tuple));
+          h = h*31 + std::hash<int>()(std::get<2>(tuple));
+          sum += h;
+        }
+      return sum;
+    });
+  Benchmark("shift/mask HashMix",num_labels,repetitions,
+    [&]() {
+      std::uint64_t sum = 0;
+      for (std::uint32_t word : words)
+        sum += mcutils::HashMix(word);
+      return sum;
+    });
+
+  // termination
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+
+  profiling_bench.cpp
+
+  Overhead of timers in profiling.h, per start/stop pair.
+
+  Usage: profiling_bench [iterations]
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+// enable profiling regions for this benchmark, regardless of build option
+#ifndef MCUTILS_PROFILING
+#define MCUTILS_PROFILING
+#endif
+
+#include "mcutils/profiling.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// prevent optimizer from discarding results
+volatile double sink;
+
+template<typename F>
+void Benchmark(const char* name, long iterations, F f)
+// Time f() over iterations, and report time per call.
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (long i=0; i<iterations; ++i)
+    f();
+  const std::chrono::duration<double> time = std::chrono::steady_clock::now()-start;
+  std::printf("  %-28s %8.2f ns\n",name,1e9*time.count()/iterations);
+}
+
+int main(int argc, char **argv)
+{
+  const long iterations = (argc>1) ? std::atol(argv[1]) : 10000000;
+
+  std::printf("profiling_bench: %ld iterations\n",iterations);
+  std::printf("cycle counter: %s, %.4f GHz\n",
+              MCUTILS_HAS_CYCLE_COUNTER ? "hardware" : "steady_clock (fallback)",
+              mcutils::CycleCounterFrequency()/1e9);
+
+  std::printf("clock read\n");
+  Benchmark("steady_clock::now",iterations,
+    [](){sink = double(std::chrono::steady_clock::now().time_since_epoch().count());});
+  Benchmark("ReadCycleCounter",iterations,
+    [](){sink = double(mcutils::ReadCycleCounter());});
+
+  std::printf("start/stop pair\n");
+  mcutils::SteadyTimer steady_timer;
+  Benchmark("SteadyTimer",iterations,
+    [&](){steady_timer.Start(); steady_timer.Stop();});
+  sink = steady_timer.ElapsedTime();
+  mcutils::CycleTimer cycle_timer;
+  Benchmark("CycleTimer",iterations,
+    [&](){cycle_timer.Start(); cycle_timer.Stop();});
+  sink = cycle_timer.ElapsedTime();
+  Benchmark("ScopedTimer",iterations,
+    [](){MCUTILS_PROFILE_SCOPE("region");});
+
+  std::printf("accumulated (timer overhead only)\n");
+  std::printf("  %-28s %8.2f ns\n","SteadyTimer",1e9*steady_timer.ElapsedTime()/iterations);
+  std::printf("  %-28s %8.2f ns\n","CycleTimer",1e9*cycle_timer.ElapsedTime()/iterations);
+
+  // termination
+  return EXIT_SUCCESS;
+}
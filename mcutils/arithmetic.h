@@ -11,6 +11,7 @@
   - 6/9/17 (mac): Move into namespace mcutils.
   - 11/5/17 (mac): Add UnitStep based on acm (wcl).
   - 09/24/21 (pjf): Make functions constexpr.
+  - 10/17/26: Add HashMix.
 
 ****************************************************************/
 
@@ -20,6 +21,8 @@
 // ONLYIF(cond,x) evaluates and returns x only if cond is true
 #define ONLYIF(cond,x) ( (cond) ? (x) : 0)
 
+#include <cstdint>
+
 namespace mcutils
 {
   ////////////////////////////////////////////////////////////////
@@ -55,6 +58,23 @@ namespace mcutils
       return (x>=0) ? 1 : 0;
     }
 
+  inline constexpr
+    std::uint64_t HashMix(std::uint64_t x)
+    // Scramble bits of 64-bit integer, for use in hashing.
+    //
+    // This is the finalizer of the splitmix64 generator: a bijection
+    // in which every input bit affects every output bit.  It turns
+    // keys which differ only in a few (e.g., low) bits, or an identity
+    // std::hash, into well-distributed hash values.
+    {
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9ULL;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebULL;
+      x ^= x >> 31;
+      return x;
+    }
+
 
 }  // namespace
 
@@ -11,18 +11,49 @@
 
   - 08/10/21 (pjf): Created.
   - 04/06/22 (pjf): Fixed constructors and added documentation.
+  - 10/17/26: Add from_bitrep, field descriptors with get/set by
+    descriptor, and pack/unpack to and from std::tuple.
+  - 10/17/26: Support 128-bit storage (uint128_t), with fields which
+    straddle 64-bit words, and shift values in storage type on
+    assignment.
+  - 10/17/26: Initialize storage in all constructors rather than
+    assigning to inactive union members; default copy constructor.
+  - 10/17/26: Support field filling entire storage word in bit_field.
 
 ****************************************************************/
 
 #ifndef MCUTILS_BIT_TUPLE_H_
 #define MCUTILS_BIT_TUPLE_H_
 
+#include <array>
+#include <climits>
+#include <cstdint>
 #include <functional>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
+#include "arithmetic.h"
+
 namespace mcutils
 {
+#if defined(__SIZEOF_INT128__)
+// 128-bit unsigned storage type, for labels wider than 64 bits
+//
+// Fields of a bit_tuple with this storage type may straddle the
+// boundary between the low and high 64-bit words.  Shifts, masks, and
+// comparisons are carried out by the compiler on the word pair without
+// branches.
+//
+// Note that in strict ISO mode (no GNU extensions), std::is_integral
+// is false for this type, and there is no std::hash for it, so field
+// values are converted to and from the storage type explicitly.
+//
+//   Ex:
+//     using label_type = mcutils::bit_tuple<mcutils::uint128_t, 40, 40, 40>;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
 // template declarations
 template<typename tStorageType, std::size_t... args> struct bit_tuple;
 template<typename tStorageType, std::size_t offset, std::size_t size>
@@ -40,7 +71,9 @@ struct bit_field
       "bit field exceeds storage boundaries"
     );
   using storage_type = tStorageType;
-  static constexpr tStorageType max_value = (tStorageType(1) << size) - 1;
+  static constexpr tStorageType max_value =
+      (size == sizeof(tStorageType) * CHAR_BIT) ? tStorageType(~tStorageType(0))
+                                                 : tStorageType((tStorageType(1) << size) - 1);
   static constexpr tStorageType mask_value = (max_value << offset);
 
   constexpr bit_field()
@@ -73,15 +106,23 @@ struct bit_field
   }
 
   // assignment equal to a normal integer type
-  template<typename T, typename std::enable_if_t<std::is_integral_v<T>>* = nullptr>
+  //   value is converted to storage type before shift, since offset may
+  //   exceed width of T
+  template<
+      typename T,
+      typename std::enable_if_t<std::is_integral_v<T> || std::is_same_v<T, tStorageType>>* = nullptr
+    >
   inline constexpr bit_field& operator=(T v)
   {
-    storage = (storage & ~mask_value) | ((v << offset) & mask_value);
+    storage = (storage & ~mask_value) | ((tStorageType(v) << offset) & mask_value);
     return *this;
   }
 
   // conversion to integer types
-  template<typename T, typename std::enable_if_t<std::is_integral_v<T>>* = nullptr>
+  template<
+      typename T,
+      typename std::enable_if_t<std::is_integral_v<T> || std::is_same_v<T, tStorageType>>* = nullptr
+    >
   explicit inline constexpr operator T() const
   {
     return static_cast<T>((storage >> offset) & max_value);
@@ -126,10 +167,16 @@ struct bit_field
 };
 
 // base case of recursive template; just has a trivial union containing the
-// underlying storage type
+// underlying storage type, initialized to zero so that bits not covered by
+// any field are well defined
 template<typename tStorageType> struct bit_tuple<tStorageType>
 {
-  constexpr bit_tuple() = default;
+  constexpr bit_tuple()
+      : storage{}
+  {}
+
+  // get bit representation of tuple
+  inline constexpr tStorageType bitrep() const { return storage; }
 
  private:
   union
@@ -152,10 +199,14 @@ struct bit_tuple<tStorageType, size, args...>
       : storage{}
   {}
 
-  // copy constructor -- just copy storage
-  constexpr bit_tuple(const bit_tuple& t)
-      : storage{t.storage}
-  {}
+  // copy constructor -- trivial copy of storage
+  //
+  // Defaulted (rather than initializing the anonymous union member from
+  // the source) so that copies are plain copies of the object
+  // representation.  GCC 12 at -O2 miscompiles the chained construction in
+  // std::stable_sort's temporary buffer for a user-provided copy
+  // constructor of this form.
+  constexpr bit_tuple(const bit_tuple& t) = default;
 
   // copy assignment operator -- just copy storage
   constexpr bit_tuple& operator=(const bit_tuple& t)
@@ -166,16 +217,21 @@ struct bit_tuple<tStorageType, size, args...>
 
   // recursive template constructor -- peel off one element, pass remaining
   // arguments down to lower-level constructor
+  //
+  // The storage is initialized directly, from the lower-level tuple's bits
+  // and this field's bits, so that only the active union member is ever
+  // written during construction.
   template<
       typename T,
       typename... cArgs,
       typename std::enable_if_t<!std::is_convertible_v<T, bit_tuple>>* = nullptr
     >
   constexpr bit_tuple(T&& v, cArgs&&... c)
-      : others{std::forward<cArgs>(c)...}
-  {
-    field = std::forward<T>(v);
-  }
+      : storage{
+            (bit_tuple<tStorageType, args...>(std::forward<cArgs>(c)...).bitrep() & ~field_type::mask_value)
+            | field_bitrep(std::forward<T>(v))
+          }
+  {}
 
   // unified comparison operator
 #if (__cplusplus >= 202002L)
@@ -194,16 +250,36 @@ struct bit_tuple<tStorageType, size, args...>
   // get bit representation of tuple
   inline constexpr tStorageType bitrep() const { return storage; }
 
+  // construct from bit representation
+  static inline constexpr bit_tuple from_bitrep(tStorageType bits)
+  {
+    bit_tuple t;
+    t.storage = bits;
+    return t;
+  }
+
  private:
   // mark impl::Get as friend so it can access private union members
   template<std::size_t, typename> friend class impl::Get;
 
+  // this field -- offset is sum of all other fields' sizes
+  using field_type = bit_field<tStorageType, (args + ... + 0), size>;
+
+  // bit representation of value assigned to this field
+  template<typename T>
+  static inline constexpr tStorageType field_bitrep(T&& v)
+  {
+    field_type f;
+    f = std::forward<T>(v);
+    return f.bitrep();
+  }
+
   union
   {
     // underlying storage type
     tStorageType storage;
-    // this field -- offset is sum of all other fields' sizes
-    bit_field<tStorageType, (args + ... + 0), size> field;
+    // this field
+    field_type field;
     // other fields -- recursive template
     bit_tuple<tStorageType, args...> others;
   };
@@ -280,6 +356,175 @@ constexpr auto const&& get(bit_tuple<tStorageType, Args...> const&& t)
     );
 }
 
+
+////////////////////////////////////////////////////////////////
+// field descriptors
+////////////////////////////////////////////////////////////////
+
+// compile-time layout of a bit_tuple type
+//
+// Fields are numbered from 0, and the first field occupies the most
+// significant bits of the storage.
+template<typename tBitTuple> struct bit_tuple_traits;
+
+template<typename tStorageType, std::size_t... sizes>
+struct bit_tuple_traits<bit_tuple<tStorageType, sizes...>>
+{
+  using storage_type = tStorageType;
+  static constexpr std::size_t num_fields = sizeof...(sizes);
+  static constexpr std::size_t total_size = (sizes + ... + 0);
+  static constexpr std::array<std::size_t, num_fields> field_sizes{sizes...};
+
+  // offset of each field -- sum of sizes of all following fields
+  static constexpr std::array<std::size_t, num_fields> field_offsets = []() {
+    std::array<std::size_t, num_fields> offsets{};
+    std::size_t offset = total_size;
+    for (std::size_t i = 0; i < num_fields; ++i)
+    {
+      offset -= field_sizes[i];
+      offsets[i] = offset;
+    }
+    return offsets;
+  }();
+};
+
+// descriptor for field of a bit_tuple type
+//
+// A descriptor gives the field's offset, size, and mask as
+// compile-time constants, and extracts or inserts the field with a
+// single shift and mask, independent of the recursive bit_tuple
+// layout.  Descriptors may be declared as named constants, to give
+// named access to fields:
+//
+//   using label_type = mcutils::bit_tuple<std::uint32_t, 8, 8, 16>;
+//   constexpr mcutils::bit_tuple_field<label_type, 0> kN{};
+//   constexpr mcutils::bit_tuple_field<label_type, 2> kM{};
+//   label_type label(...);
+//   auto n = mcutils::get(label, kN);
+//   mcutils::set(label, kM, 5);
+template<typename tBitTuple, std::size_t tIndex>
+struct bit_tuple_field
+{
+  using traits = bit_tuple_traits<tBitTuple>;
+  using storage_type = typename traits::storage_type;
+  static_assert(tIndex < traits::num_fields, "bit_tuple field index out of range");
+
+  static constexpr std::size_t index = tIndex;
+  static constexpr std::size_t offset = traits::field_offsets[tIndex];
+  static constexpr std::size_t size = traits::field_sizes[tIndex];
+  static constexpr storage_type max_value =
+      (size == sizeof(storage_type) * CHAR_BIT) ? storage_type(~storage_type(0))
+                                                : storage_type((storage_type(1) << size) - 1);
+  static constexpr storage_type mask_value = storage_type(max_value << offset);
+
+  // get field value from bit representation
+  static inline constexpr storage_type extract(storage_type bits)
+  {
+    return (bits >> offset) & max_value;
+  }
+
+  // get bit representation of value in field position
+  static inline constexpr storage_type shift(storage_type value)
+  {
+    return (value << offset) & mask_value;
+  }
+
+  // replace field value in bit representation
+  static inline constexpr storage_type insert(storage_type bits, storage_type value)
+  {
+    return (bits & ~mask_value) | shift(value);
+  }
+};
+
+// get value of field by descriptor
+template<typename tBitTuple, std::size_t tIndex>
+constexpr auto get(const tBitTuple& t, bit_tuple_field<tBitTuple, tIndex>)
+{
+  return bit_tuple_field<tBitTuple, tIndex>::extract(t.bitrep());
+}
+
+// set value of field by descriptor
+template<typename tBitTuple, std::size_t tIndex>
+constexpr void set(
+    tBitTuple& t,
+    bit_tuple_field<tBitTuple, tIndex>,
+    typename bit_tuple_traits<tBitTuple>::storage_type value
+  )
+{
+  t = tBitTuple::from_bitrep(
+      bit_tuple_field<tBitTuple, tIndex>::insert(t.bitrep(), value)
+    );
+}
+
+////////////////////////////////////////////////////////////////
+// bulk pack/unpack
+////////////////////////////////////////////////////////////////
+
+namespace impl
+{
+template<typename tBitTuple, typename tTuple, std::size_t... indices>
+constexpr tBitTuple pack_bit_tuple(const tTuple& values, std::index_sequence<indices...>)
+{
+  using storage_type = typename bit_tuple_traits<tBitTuple>::storage_type;
+  return tBitTuple::from_bitrep(
+      (storage_type(0) | ... | bit_tuple_field<tBitTuple, indices>::shift(
+          static_cast<storage_type>(std::get<indices>(values))
+        ))
+    );
+}
+
+template<typename tBitTuple, std::size_t... indices>
+constexpr auto unpack_bit_tuple(const tBitTuple& t, std::index_sequence<indices...>)
+{
+  const auto bits = t.bitrep();
+  return std::make_tuple(bit_tuple_field<tBitTuple, indices>::extract(bits)...);
+}
+}  // namespace impl
+
+// pack tuple of integers into bit_tuple
+//   each value is shifted and masked into its field, and the fields
+//   are combined by bitwise or
+template<typename tBitTuple, typename... Ts>
+constexpr tBitTuple pack_bit_tuple(const std::tuple<Ts...>& values)
+{
+  static_assert(
+      sizeof...(Ts) == bit_tuple_traits<tBitTuple>::num_fields,
+      "number of values must match number of bit_tuple fields"
+    );
+  return impl::pack_bit_tuple<tBitTuple>(values, std::index_sequence_for<Ts...>{});
+}
+
+// unpack bit_tuple into tuple of field values (of the storage type)
+//   each field is extracted by a single shift and mask
+//
+//   Ex:
+//     auto [n, l, m] = mcutils::unpack_bit_tuple(label);
+template<typename tStorageType, std::size_t... sizes>
+constexpr auto unpack_bit_tuple(const bit_tuple<tStorageType, sizes...>& t)
+{
+  return impl::unpack_bit_tuple(t, std::make_index_sequence<sizeof...(sizes)>{});
+}
+
+namespace impl
+{
+// hash of storage word
+//   words wider than 64 bits are mixed 64 bits at a time, so that
+//   every bit affects the hash
+template<typename tWord>
+constexpr std::uint64_t hash_bit_tuple_word(tWord word)
+{
+  if constexpr (sizeof(tWord) <= sizeof(std::uint64_t))
+  {
+    return HashMix(static_cast<std::uint64_t>(word));
+  }
+  else
+  {
+    static_assert(sizeof(tWord) == 2 * sizeof(std::uint64_t), "unsupported storage word size");
+    return HashMix(static_cast<std::uint64_t>(word) ^ HashMix(static_cast<std::uint64_t>(word >> 64)));
+  }
+}
+}  // namespace impl
+
 }  // namespace mcutils
 
 
@@ -292,7 +537,11 @@ struct hash<mcutils::bit_tuple<tStorageType, args...>>
 {
   inline std::size_t operator()(const mcutils::bit_tuple<tStorageType, args...>& t) const noexcept
   {
-    return std::hash<tStorageType>()(t.bitrep());
+    // words wider than std::size_t have no std::hash, so mix all bits
+    if constexpr (sizeof(tStorageType) <= sizeof(std::size_t))
+      return std::hash<tStorageType>()(t.bitrep());
+    else
+      return std::size_t(mcutils::impl::hash_bit_tuple_word(t.bitrep()));
   }
 };
 }  // namespace std
@@ -0,0 +1,446 @@
+/****************************************************************
+  bit_tuple_map.h
+
+  Open-addressing hash set and map with bit_tuple keys.
+
+  std::hash<bit_tuple> forwards to std::hash of the storage word,
+  which (in libstdc++) is the identity.  Packed labels typically have
+  mostly-zero high bits, so the identity hash clusters badly in
+  std::unordered_map, and each node is a separate allocation.
+
+  BitTupleSet and BitTupleMap instead store the storage words (and
+  mapped values) in flat arrays, with no per-node allocation.  Keys
+  are hashed with HashMix (see arithmetic.h), applied to each 64-bit
+  word of the storage.  The table is divided
+  into groups of 16 slots, each with a control byte holding 7 bits of
+  the hash (or marking the slot empty or deleted), and a lookup
+  compares the control bytes of a whole group at once (with SSE2
+  where available), so that most lookups touch one group of control
+  bytes and a single key.
+
+    mcutils::BitTupleMap<label_type, std::size_t> index;
+    index[label] = i;
+    const std::size_t* i_ptr = index.find(label);
+
+  Iteration order is unspecified.  Insertion may rehash, which
+  invalidates pointers to mapped values.
+
+  - 10/17/26: Created.
+  - 10/17/26: Hash 128-bit storage words.
+  - 10/17/26: Store mapped values in slot wrapper, to support bool.
+
+****************************************************************/
+
+#ifndef MCUTILS_BIT_TUPLE_MAP_H_
+#define MCUTILS_BIT_TUPLE_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "bit_tuple.h"
+
+namespace mcutils
+{
+
+namespace impl
+{
+
+////////////////////////////////////////////////////////////////
+// hashing and control bytes
+////////////////////////////////////////////////////////////////
+
+// control byte values
+//   full slots hold 7 low bits of hash (nonnegative)
+constexpr std::int8_t kCtrlEmpty = -128;
+constexpr std::int8_t kCtrlDeleted = -2;
+
+// index of lowest set bit in nonzero mask
+inline unsigned lowest_bit(std::uint32_t mask)
+{
+#if defined(__GNUC__)
+  return unsigned(__builtin_ctz(mask));
+#else
+  unsigned i = 0;
+  while (!(mask & 1u))
+  {
+    mask >>= 1;
+    ++i;
+  }
+  return i;
+#endif
+}
+
+// group of control bytes, compared at once
+struct bit_tuple_map_group
+{
+  static constexpr std::size_t width = 16;
+
+  explicit bit_tuple_map_group(const std::int8_t* ctrl)
+#if defined(__SSE2__)
+      : ctrl_{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))}
+#else
+      : ctrl_{ctrl}
+#endif
+  {}
+
+  // mask of slots with given control byte
+  std::uint32_t match(std::int8_t h2) const
+  {
+#if defined(__SSE2__)
+    return std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(h2))));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < width; ++i)
+      mask |= std::uint32_t(ctrl_[i] == h2) << i;
+    return mask;
+#endif
+  }
+
+  // mask of empty slots
+  std::uint32_t match_empty() const { return match(kCtrlEmpty); }
+
+  // mask of empty or deleted slots (i.e., negative control bytes)
+  std::uint32_t match_empty_or_deleted() const
+  {
+#if defined(__SSE2__)
+    return std::uint32_t(_mm_movemask_epi8(ctrl_));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < width; ++i)
+      mask |= std::uint32_t(ctrl_[i] < 0) << i;
+    return mask;
+#endif
+  }
+
+ private:
+#if defined(__SSE2__)
+  __m128i ctrl_;
+#else
+  const std::int8_t* ctrl_;
+#endif
+};
+
+////////////////////////////////////////////////////////////////
+// table
+////////////////////////////////////////////////////////////////
+
+// storage for one mapped value
+//   wrapped so that std::vector of slots is never the bit-packed
+//   std::vector<bool>, and values are addressable
+template<typename T>
+struct bit_tuple_map_slot
+{
+  T value{};
+};
+
+// open-addressing table of storage words, with optional mapped values
+//   (none if tMapped is void)
+template<typename tBitTuple, typename tMapped>
+class bit_tuple_table
+{
+ public:
+  using key_type = tBitTuple;
+  using storage_type = typename bit_tuple_traits<tBitTuple>::storage_type;
+  using size_type = std::size_t;
+  static constexpr size_type npos = size_type(-1);
+  static constexpr size_type group_width = bit_tuple_map_group::width;
+
+  bit_tuple_table() { clear(); }
+
+  // number of entries
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // number of slots
+  size_type capacity() const { return ctrl_.size(); }
+
+  // remove all entries and release storage
+  void clear()
+  {
+    ctrl_.assign(group_width, kCtrlEmpty);
+    keys_.assign(group_width, storage_type(0));
+    if constexpr (has_values)
+      values_.assign(group_width, mapped_storage_type{});
+    size_ = 0;
+    num_deleted_ = 0;
+  }
+
+  // ensure room for count entries without rehashing
+  void reserve(size_type count)
+  {
+    size_type new_capacity = group_width;
+    while (max_load(new_capacity) < count)
+      new_capacity *= 2;
+    if (new_capacity > capacity())
+      rehash(new_capacity);
+  }
+
+  // test for presence of key
+  bool contains(const tBitTuple& key) const { return find_slot(key.bitrep()) != npos; }
+
+  // remove key, returning whether it was present
+  bool erase(const tBitTuple& key)
+  {
+    const size_type slot = find_slot(key.bitrep());
+    if (slot == npos)
+      return false;
+    ctrl_[slot] = kCtrlDeleted;
+    if constexpr (has_values)
+      values_[slot] = mapped_storage_type{};
+    --size_;
+    ++num_deleted_;
+    return true;
+  }
+
+  // iterator over full slots of derived table
+  template<typename tTable, typename tReference>
+  class slot_iterator
+  {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::decay_t<tReference>;
+    using difference_type = std::ptrdiff_t;
+    using reference = tReference;
+    struct pointer
+    {
+      reference value;
+      const reference* operator->() const { return &value; }
+    };
+
+    slot_iterator() = default;
+    slot_iterator(const tTable* table, size_type slot)
+        : table_{table}, slot_{slot}
+    {
+      skip();
+    }
+
+    reference operator*() const { return table_->slot_reference(slot_); }
+    pointer operator->() const { return pointer{**this}; }
+    slot_iterator& operator++()
+    {
+      ++slot_;
+      skip();
+      return *this;
+    }
+    slot_iterator operator++(int)
+    {
+      slot_iterator it = *this;
+      ++*this;
+      return it;
+    }
+    friend bool operator==(const slot_iterator& a, const slot_iterator& b) { return a.slot_ == b.slot_; }
+    friend bool operator!=(const slot_iterator& a, const slot_iterator& b) { return a.slot_ != b.slot_; }
+
+   private:
+    void skip()
+    {
+      while ((slot_ < table_->capacity()) && (table_->ctrl_[slot_] < 0))
+        ++slot_;
+    }
+
+    const tTable* table_ = nullptr;
+    size_type slot_ = 0;
+  };
+
+ protected:
+  static constexpr bool has_values = !std::is_void_v<tMapped>;
+  using mapped_storage_type = bit_tuple_map_slot<std::conditional_t<has_values, tMapped, char>>;
+
+  // maximum number of full or deleted slots for capacity (7/8 load)
+  static size_type max_load(size_type capacity) { return capacity - capacity / 8; }
+
+  // find slot containing key, or npos
+  size_type find_slot(storage_type word) const
+  {
+    const std::uint64_t hash = hash_bit_tuple_word(word);
+    const std::int8_t h2 = std::int8_t(hash & 0x7F);
+    const size_type group_mask = capacity() / group_width - 1;
+    size_type group = size_type(hash >> 7) & group_mask;
+    for (size_type probe = 1;; ++probe)
+    {
+      const bit_tuple_map_group control(&ctrl_[group * group_width]);
+      for (std::uint32_t mask = control.match(h2); mask; mask &= mask - 1)
+      {
+        const size_type slot = group * group_width + lowest_bit(mask);
+        if (keys_[slot] == word)
+          return slot;
+      }
+      if (control.match_empty())
+        return npos;
+      // triangular probe sequence visits every group
+      group = (group + probe) & group_mask;
+    }
+  }
+
+  // find slot containing key, or insert key in new slot
+  //   returns slot and whether key was inserted
+  std::pair<size_type, bool> insert_slot(storage_type word)
+  {
+    size_type slot = find_slot(word);
+    if (slot != npos)
+      return {slot, false};
+
+    if (size_ + num_deleted_ + 1 > max_load(capacity()))
+      rehash((size_ + 1 > max_load(capacity()) / 2) ? 2 * capacity() : capacity());
+
+    const std::uint64_t hash = hash_bit_tuple_word(word);
+    slot = free_slot(hash);
+    if (ctrl_[slot] == kCtrlDeleted)
+      --num_deleted_;
+    ctrl_[slot] = std::int8_t(hash & 0x7F);
+    keys_[slot] = word;
+    ++size_;
+    return {slot, true};
+  }
+
+  // first empty or deleted slot in probe sequence for hash
+  size_type free_slot(std::uint64_t hash) const
+  {
+    const size_type group_mask = capacity() / group_width - 1;
+    size_type group = size_type(hash >> 7) & group_mask;
+    for (size_type probe = 1;; ++probe)
+    {
+      const std::uint32_t mask = bit_tuple_map_group(&ctrl_[group * group_width]).match_empty_or_deleted();
+      if (mask)
+        return group * group_width + lowest_bit(mask);
+      group = (group + probe) & group_mask;
+    }
+  }
+
+  // move entries to table with given capacity (power of two)
+  //   also clears deleted slots
+  void rehash(size_type new_capacity)
+  {
+    std::vector<std::int8_t> old_ctrl(new_capacity, kCtrlEmpty);
+    std::vector<storage_type> old_keys(new_capacity, storage_type(0));
+    std::vector<mapped_storage_type> old_values(has_values ? new_capacity : 0);
+    std::swap(old_ctrl, ctrl_);
+    std::swap(old_keys, keys_);
+    std::swap(old_values, values_);
+    num_deleted_ = 0;
+
+    for (size_type old_slot = 0; old_slot < old_ctrl.size(); ++old_slot)
+    {
+      if (old_ctrl[old_slot] < 0)
+        continue;
+      const std::uint64_t hash = hash_bit_tuple_word(old_keys[old_slot]);
+      const size_type slot = free_slot(hash);
+      ctrl_[slot] = std::int8_t(hash & 0x7F);
+      keys_[slot] = old_keys[old_slot];
+      if constexpr (has_values)
+        values_[slot] = std::move(old_values[old_slot]);
+    }
+  }
+
+  // key at slot
+  tBitTuple slot_key(size_type slot) const { return tBitTuple::from_bitrep(keys_[slot]); }
+
+  std::vector<std::int8_t> ctrl_;
+  std::vector<storage_type> keys_;
+  std::vector<mapped_storage_type> values_;
+  size_type size_;
+  size_type num_deleted_;
+};
+
+}  // namespace impl
+
+////////////////////////////////////////////////////////////////
+// set
+////////////////////////////////////////////////////////////////
+
+// hash set of bit_tuple
+template<typename tBitTuple>
+class BitTupleSet : public impl::bit_tuple_table<tBitTuple, void>
+{
+  using base = impl::bit_tuple_table<tBitTuple, void>;
+
+ public:
+  using value_type = tBitTuple;
+  using const_iterator = typename base::template slot_iterator<BitTupleSet, tBitTuple>;
+  using iterator = const_iterator;
+
+  BitTupleSet() = default;
+
+  // insert key, returning whether it was newly inserted
+  bool insert(const tBitTuple& key) { return base::insert_slot(key.bitrep()).second; }
+
+  // iteration over keys (in unspecified order)
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, base::capacity()); }
+
+ private:
+  friend const_iterator;
+  tBitTuple slot_reference(typename base::size_type slot) const { return base::slot_key(slot); }
+};
+
+////////////////////////////////////////////////////////////////
+// map
+////////////////////////////////////////////////////////////////
+
+// hash map from bit_tuple to T
+//   T must be default constructible
+template<typename tBitTuple, typename T>
+class BitTupleMap : public impl::bit_tuple_table<tBitTuple, T>
+{
+  using base = impl::bit_tuple_table<tBitTuple, T>;
+  using reference_type = std::pair<tBitTuple, const T&>;
+
+ public:
+  using mapped_type = T;
+  using value_type = std::pair<tBitTuple, T>;
+  using const_iterator = typename base::template slot_iterator<BitTupleMap, reference_type>;
+  using iterator = const_iterator;
+
+  BitTupleMap() = default;
+
+  // pointer to mapped value, or nullptr if key is absent
+  T* find(const tBitTuple& key)
+  {
+    const auto slot = base::find_slot(key.bitrep());
+    return (slot == base::npos) ? nullptr : &base::values_[slot].value;
+  }
+  const T* find(const tBitTuple& key) const
+  {
+    const auto slot = base::find_slot(key.bitrep());
+    return (slot == base::npos) ? nullptr : &base::values_[slot].value;
+  }
+
+  // access mapped value, inserting default value if key is absent
+  T& operator[](const tBitTuple& key)
+  {
+    return base::values_[base::insert_slot(key.bitrep()).first].value;
+  }
+
+  // insert value if key is absent, returning whether it was inserted
+  bool insert(const tBitTuple& key, const T& value)
+  {
+    const auto [slot, inserted] = base::insert_slot(key.bitrep());
+    if (inserted)
+      base::values_[slot].value = value;
+    return inserted;
+  }
+
+  // iteration over (key, value) pairs (in unspecified order)
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, base::capacity()); }
+
+ private:
+  friend const_iterator;
+  reference_type slot_reference(typename base::size_type slot) const
+  {
+    return reference_type(base::slot_key(slot), base::values_[slot].value);
+  }
+};
+
+}  // namespace mcutils
+
+#endif  // MCUTILS_BIT_TUPLE_MAP_H_
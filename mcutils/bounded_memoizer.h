@@ -0,0 +1,429 @@
+/****************************************************************
+
+  bounded_memoizer.h
+
+  Memoizer with bounded capacity and pluggable eviction policy.
+
+  BoundedMemoizer provides the Seek/GetValue/SetValue interface of
+  mcutils::Memoizer (and so may be used with the MEMOIZE macro), but
+  holds at most a fixed number of entries.  Once the cache is full,
+  each new entry replaces one chosen by the eviction policy:
+
+    LRUEvictionPolicy: evict least recently used entry
+    ClockEvictionPolicy: CLOCK (second chance) approximation to LRU,
+      with cheaper bookkeeping on hits
+
+  Hit, miss, and eviction counters are maintained, so that the
+  capacity can be tuned against the hit rate.
+
+  An eviction policy is a class which tracks usage of the slots
+  0..capacity-1, providing:
+
+    void Reset(std::size_t capacity)  -- forget all usage history
+    void Insert(std::size_t slot)     -- slot has been (re)filled
+    void Touch(std::size_t slot)      -- slot has been accessed
+    std::size_t Victim()              -- choose slot to be refilled
+                                         (called only when all slots full)
+
+  - 10/17/26: Created.
+
+****************************************************************/
+
+#ifndef MCUTILS_BOUNDED_MEMOIZER_H_
+#define MCUTILS_BOUNDED_MEMOIZER_H_
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "memoizer.h"
+
+namespace mcutils
+{
+  ////////////////////////////////////////////////////////////////
+  // eviction policies
+  ////////////////////////////////////////////////////////////////
+
+  class LRUEvictionPolicy
+  // Least-recently-used eviction.
+  //
+  // Slots are kept in an intrusive doubly-linked list, ordered from
+  // most recently used (head) to least recently used (tail), so all
+  // operations are O(1) and allocation free.
+  {
+    public:
+
+    void Reset(std::size_t capacity)
+    {
+      prev_.assign(capacity,kNil);
+      next_.assign(capacity,kNil);
+      head_ = tail_ = kNil;
+    };
+
+    void Insert(std::size_t slot)
+    {
+      PushFront(slot);
+    };
+
+    void Touch(std::size_t slot)
+    {
+      if (slot==head_)
+        return;
+      Unlink(slot);
+      PushFront(slot);
+    };
+
+    std::size_t Victim()
+    {
+      std::size_t slot = tail_;
+      Unlink(slot);
+      return slot;
+    };
+
+    private:
+
+    static constexpr std::size_t kNil = static_cast<std::size_t>(-1);
+
+    void Unlink(std::size_t slot)
+    {
+      if (prev_[slot]!=kNil)
+        next_[prev_[slot]] = next_[slot];
+      else
+        head_ = next_[slot];
+      if (next_[slot]!=kNil)
+        prev_[next_[slot]] = prev_[slot];
+      else
+        tail_ = prev_[slot];
+      prev_[slot] = next_[slot] = kNil;
+    };
+
+    void PushFront(std::size_t slot)
+    {
+      prev_[slot] = kNil;
+      next_[slot] = head_;
+      if (head_!=kNil)
+        prev_[head_] = slot;
+      head_ = slot;
+      if (tail_==kNil)
+        tail_ = slot;
+    };
+
+    std::vector<std::size_t> prev_, next_;
+    std::size_t head_ = kNil, tail_ = kNil;
+  };
+
+  class ClockEvictionPolicy
+  // CLOCK (second chance) eviction.
+  //
+  // A hit only sets a reference bit.  To choose a victim, the clock
+  // hand sweeps over the slots, clearing reference bits, until it
+  // finds an unreferenced slot.
+  {
+    public:
+
+    void Reset(std::size_t capacity)
+    {
+      referenced_.assign(capacity,false);
+      hand_ = 0;
+    };
+
+    void Insert(std::size_t slot)
+    {
+      referenced_[slot] = true;
+    };
+
+    void Touch(std::size_t slot)
+    {
+      referenced_[slot] = true;
+    };
+
+    std::size_t Victim()
+    {
+      while (referenced_[hand_])
+        {
+          referenced_[hand_] = false;
+          Advance();
+        }
+      std::size_t slot = hand_;
+      Advance();
+      return slot;
+    };
+
+    private:
+
+    void Advance()
+    {
+      if (++hand_==referenced_.size())
+        hand_ = 0;
+    };
+
+    std::vector<char> referenced_;
+    std::size_t hand_ = 0;
+  };
+
+  ////////////////////////////////////////////////////////////////
+  // BoundedMemoizer
+  ////////////////////////////////////////////////////////////////
+
+  template<typename Key, typename T,
+    typename EvictionPolicy = LRUEvictionPolicy,
+    typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key> >
+    class BoundedMemoizer{
+
+    public:
+
+    ////////////////////////////////
+    // type definitions
+    ////////////////////////////////
+
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key,T> value_type;
+    typedef EvictionPolicy eviction_policy_type;
+    typedef std::size_t size_type;
+
+    // entry storage (one element per slot)
+    typedef std::vector<value_type> vector_type;
+    typedef typename vector_type::const_iterator const_iterator;
+
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    // construct with given capacity (maximum number of entries)
+    //   enable or disable caching
+    explicit BoundedMemoizer(size_type capacity, bool b = true)
+      : cache_enabled_(b), capacity_(capacity)
+    {
+      clear();
+    };
+
+    ////////////////////////////////
+    // accessors
+    ////////////////////////////////
+
+    // Seek(x) seeks entry for key x, returns true if found
+    //   as side effect, saves "y" value for subsequent rapid
+    //   access by GetValue(), and counts a hit or miss
+    bool Seek(const Key& x);
+
+    // GetValue() returns the "y" value for
+    //   the most recently sought key
+    //   note: this requires that no recursive call be made
+    //   before GetValue() invoked
+    T GetValue() const {return current_result_;};
+
+    // SetValue(y) stores y value, evicting an entry if the cache is
+    //   full, and returns a copy of this value
+    T SetValue(const Key& x, const T& y);
+
+    // Known(x) determines whether or not a value for x is currently stored
+    //   for debugging and diagnostic use -- not part of MEMOIZE call,
+    //   and does not count as an access
+    bool Known(const Key& x) const {return (index_.count(x) == 1);}
+
+    ////////////////////////////////
+    // iterators
+    ////////////////////////////////
+
+    // iterators for read access only are defined
+    //   note: iteration order is slot order
+
+    const_iterator begin() const {return values_.begin();};
+    const_iterator end() const {return values_.end();};
+
+    ////////////////////////////////
+    // bulk access
+    ////////////////////////////////
+
+    size_type size() const {return values_.size();};
+    size_type capacity() const {return capacity_;};
+
+    // clear() removes all entries (statistics counters are retained)
+    void clear();
+
+    ////////////////////////////////
+    // statistics
+    ////////////////////////////////
+
+    size_type hits() const {return hits_;};
+    size_type misses() const {return misses_;};
+    size_type evictions() const {return evictions_;};
+
+    // hit rate (fraction of Seek calls which found their key)
+    double HitRate() const
+    {
+      size_type lookups = hits_+misses_;
+      return (lookups==0) ? 0. : static_cast<double>(hits_)/lookups;
+    };
+
+    void ResetStatistics() {hits_ = misses_ = evictions_ = 0;};
+
+    ////////////////////////////////
+    // ostream output
+    ////////////////////////////////
+
+    // output operator -- friend declaration for access to delimiters
+    template<typename KeyX, typename TX, typename EvictionPolicyX, typename HashX, typename KeyEqualX>
+    friend std::ostream& operator<< (std::ostream&, const BoundedMemoizer<KeyX,TX,EvictionPolicyX,HashX,KeyEqualX>&);
+
+    ////////////////////////////////
+    // configuration
+    ////////////////////////////////
+
+    // mode flags
+    void EnableCaching(bool b) {cache_enabled_ = b;};
+
+    // configuring delimiter strings
+    //   static member function sets delimiters for *all* BoundedMemoizer
+    //   instances with the given template parameters
+    static void SetDelimiters(const std::string&, const std::string&, const std::string&);
+
+    private:
+
+    ////////////////////////////////
+    // configuration data
+    ////////////////////////////////
+
+    // ostream delimiters (static)
+    static std::string delimiter_left_;
+    static std::string delimiter_middle_;
+    static std::string delimiter_right_;
+
+    // mode variables
+    bool cache_enabled_;
+    size_type capacity_;
+
+    ////////////////////////////////
+    // caching data
+    ////////////////////////////////
+
+    // entries, by slot
+    vector_type values_;
+
+    // slot lookup by key
+    std::unordered_map<Key,size_type,Hash,KeyEqual> index_;
+
+    // slot usage tracking
+    eviction_policy_type policy_;
+
+    // current entry access
+    T current_result_;
+
+    // statistics
+    size_type hits_ = 0, misses_ = 0, evictions_ = 0;
+
+  };
+
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    void BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::clear()
+    {
+      values_.clear();
+      values_.reserve(capacity_);
+      index_.clear();
+      index_.reserve(capacity_);
+      policy_.Reset(capacity_);
+    }
+
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    inline
+    bool BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::Seek(const Key& x)
+    {
+      if (!cache_enabled_)
+        return false;
+
+      auto it = index_.find(x);
+      if (it == index_.end())
+        {
+          ++misses_;
+          return false;
+        }
+
+      ++hits_;
+      policy_.Touch(it->second);
+      current_result_ = values_[it->second].second;
+      return true;
+    }
+
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    T BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::SetValue(const Key& x, const T& y)
+    {
+      if (!cache_enabled_ || (capacity_==0))
+        return y;
+
+      // existing entry (e.g., stored by recursive call) is retained
+      if (index_.count(x))
+        return y;
+
+      if (values_.size() < capacity_)
+        // fill next free slot
+        {
+          index_.emplace(x,values_.size());
+          policy_.Insert(values_.size());
+          values_.emplace_back(x,y);
+        }
+      else
+        // replace victim
+        {
+          size_type slot = policy_.Victim();
+          index_.erase(values_[slot].first);
+          index_.emplace(x,slot);
+          values_[slot].first = x;
+          values_[slot].second = y;
+          policy_.Insert(slot);
+          ++evictions_;
+        }
+
+      return y;
+    }
+
+  ////////////////////////////////
+  // stream output
+  ////////////////////////////////
+
+  // initialize delimiter variables
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    std::string BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::delimiter_left_("  ");
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    std::string BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::delimiter_middle_("->");
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    std::string BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::delimiter_right_("\n");
+
+  // delimiter configuration
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    void BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::SetDelimiters(
+        const std::string& left,
+        const std::string& middle,
+        const std::string& right
+      )
+    {
+      BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::delimiter_left_ = left;
+      BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::delimiter_middle_ = middle;
+      BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>::delimiter_right_ = right;
+    };
+
+  // output operator
+  template<typename Key, typename T, typename EvictionPolicy, typename Hash, typename KeyEqual>
+    std::ostream& operator<< (std::ostream& os, const BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual>& m)
+  {
+    typedef BoundedMemoizer<Key,T,EvictionPolicy,Hash,KeyEqual> memoizer_type;
+    for(typename memoizer_type::const_iterator i = m.begin(); i != m.end(); ++i)
+      {
+        os << memoizer_type::delimiter_left_;
+        os << i->first;
+        os << memoizer_type::delimiter_middle_;
+        os << i->second;
+        os << memoizer_type::delimiter_right_;
+      }
+
+    return os;
+  }
+
+}  // namespace
+
+#endif
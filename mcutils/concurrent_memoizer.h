@@ -0,0 +1,251 @@
+/****************************************************************
+
+  concurrent_memoizer.h
+
+  Thread-safe memoizer for use inside parallel regions.
+
+  The Seek/GetValue/SetValue protocol of mcutils::Memoizer keeps the
+  most recently sought value as member state, so a single Memoizer
+  cannot be shared between threads.  ConcurrentMemoizer instead
+  provides a single atomic get-or-compute operation:
+
+    static mcutils::ConcurrentMemoizer<Key,double> m;
+    #pragma omp parallel for
+    for (...)
+      x += m.GetOrCompute(key, [&](){return ExpensiveFunction(key);});
+
+  Entries are distributed over independently-locked shards, so
+  threads only contend when they touch the same shard at the same
+  time.  Each value is computed exactly once: if several threads
+  request the same missing key, one runs the functor and the others
+  wait for its result.
+
+  - 10/17/26: Created.
+
+****************************************************************/
+
+#ifndef MCUTILS_CONCURRENT_MEMOIZER_H_
+#define MCUTILS_CONCURRENT_MEMOIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace mcutils
+{
+  ////////////////////////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////
+
+  template<typename Key, typename T,
+    typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key> >
+    class ConcurrentMemoizer{
+
+    public:
+
+    ////////////////////////////////
+    // type definitions
+    ////////////////////////////////
+
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+    typedef std::size_t size_type;
+
+    // default number of shards
+    //   chosen generously, so that even with 64+ threads the chance of
+    //   two threads simultaneously touching the same shard is small
+    static constexpr size_type kDefaultNumShards = 256;
+
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    // construct with given number of shards (rounded up to a power of 2)
+    explicit ConcurrentMemoizer(size_type num_shards = kDefaultNumShards)
+    {
+      log2_shards_ = 0;
+      while ((size_type(1) << log2_shards_) < num_shards)
+        ++log2_shards_;
+      shards_.reset(new Shard[NumShards()]);
+    };
+
+    // not copyable, since entries are shared between threads
+    ConcurrentMemoizer(const ConcurrentMemoizer&) = delete;
+    ConcurrentMemoizer& operator=(const ConcurrentMemoizer&) = delete;
+
+    ////////////////////////////////
+    // accessors
+    ////////////////////////////////
+
+    template<typename F>
+      const T& GetOrCompute(const Key& x, F&& f);
+    // Look up value for key x, computing it as f() if not yet known.
+    //
+    // Thread safe.  The functor is invoked at most once per key (unless
+    // it throws, in which case a later caller retries the computation).
+    // Other threads requesting the same key block until the value is
+    // available.  The lock for the key's shard is *not* held while f()
+    // runs, so f() may itself invoke GetOrCompute for other keys.
+    //
+    // Caution: f() must not (even indirectly) request the same key x,
+    // which would deadlock.
+    //
+    // Returns:
+    //   (const T&) : reference to stored value, valid until clear()
+
+    bool Known(const Key& x) const;
+    // Determine whether or not a value for x has been computed.
+    //
+    // Thread safe.  For debugging and diagnostic use.
+
+    ////////////////////////////////
+    // bulk access
+    ////////////////////////////////
+
+    size_type size() const;
+    // Number of entries (including any still being computed).
+    //
+    // Thread safe, but only a snapshot if other threads are inserting.
+
+    void clear();
+    // Remove all entries.
+    //
+    // Not thread safe: must not be called concurrently with any other
+    // member function.
+
+    size_type NumShards() const {return size_type(1) << log2_shards_;};
+
+    private:
+
+    ////////////////////////////////
+    // internal data types
+    ////////////////////////////////
+
+    // cache entry
+    //   populated exactly once, under the once_flag
+    struct Entry
+    {
+      std::once_flag once;
+      std::atomic<bool> ready{false};
+      std::optional<T> value;
+    };
+
+    // shard -- independently locked hash map
+    //   cache-line aligned so that locks of neighboring shards do not
+    //   share a cache line
+    //
+    //   Entries are never moved once created (std::unordered_map is
+    //   node-based), so references to them remain valid after the
+    //   shard lock is released.
+    struct alignas(64) Shard
+    {
+      mutable std::shared_mutex mutex;
+      std::unordered_map<Key,Entry,Hash,KeyEqual> entries;
+    };
+
+    ////////////////////////////////
+    // internal helpers
+    ////////////////////////////////
+
+    // ShardFor(x) returns shard responsible for key x
+    //
+    // Uses high bits of scrambled hash, so shard selection is
+    // independent of the low bits used for bucket selection within
+    // the shard.
+    Shard& ShardFor(const Key& x) const
+    {
+      if (log2_shards_ == 0)
+        return shards_[0];
+      const std::uint64_t h = static_cast<std::uint64_t>(hasher_(x))*UINT64_C(0x9E3779B97F4A7C15);
+      return shards_[h >> (64-log2_shards_)];
+    }
+
+    ////////////////////////////////
+    // data
+    ////////////////////////////////
+
+    unsigned int log2_shards_;
+    std::unique_ptr<Shard[]> shards_;
+    hasher hasher_;
+
+  };
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    template<typename F>
+    const T& ConcurrentMemoizer<Key,T,Hash,KeyEqual>::GetOrCompute(const Key& x, F&& f)
+    {
+      Shard& shard = ShardFor(x);
+      Entry* entry_ptr = nullptr;
+
+      // fast path: look up existing entry under shared lock
+      {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(x);
+        if (it != shard.entries.end())
+          entry_ptr = &(it->second);
+      }
+
+      // slow path: create entry under exclusive lock
+      //   another thread may have created it in the meantime, in which
+      //   case try_emplace simply returns the existing entry
+      if (!entry_ptr)
+        {
+          std::unique_lock<std::shared_mutex> lock(shard.mutex);
+          entry_ptr = &(shard.entries.try_emplace(x).first->second);
+        }
+
+      // compute value, if not already done by some thread
+      Entry& entry = *entry_ptr;
+      if (!entry.ready.load(std::memory_order_acquire))
+        std::call_once(
+            entry.once,
+            [&]()
+            {
+              entry.value.emplace(std::forward<F>(f)());
+              entry.ready.store(true,std::memory_order_release);
+            }
+          );
+
+      return *entry.value;
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    bool ConcurrentMemoizer<Key,T,Hash,KeyEqual>::Known(const Key& x) const
+    {
+      const Shard& shard = ShardFor(x);
+      std::shared_lock<std::shared_mutex> lock(shard.mutex);
+      auto it = shard.entries.find(x);
+      return (it != shard.entries.end()) && it->second.ready.load(std::memory_order_acquire);
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    typename ConcurrentMemoizer<Key,T,Hash,KeyEqual>::size_type
+    ConcurrentMemoizer<Key,T,Hash,KeyEqual>::size() const
+    {
+      size_type total = 0;
+      for (size_type i = 0; i < NumShards(); ++i)
+        {
+          std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+          total += shards_[i].entries.size();
+        }
+      return total;
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    void ConcurrentMemoizer<Key,T,Hash,KeyEqual>::clear()
+    {
+      for (size_type i = 0; i < NumShards(); ++i)
+        shards_[i].entries.clear();
+    }
+
+}  // namespace
+
+#endif
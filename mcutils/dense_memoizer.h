@@ -0,0 +1,392 @@
+/****************************************************************
+
+  dense_memoizer.h
+
+  Memoizer for keys which are small tuples of bounded integers.
+
+  DenseMemoizer provides the Seek/GetValue/SetValue interface of
+  mcutils::Memoizer (and so may be used with the MEMOIZE macro), but
+  stores its values in a flat array indexed by the key, with a bitmap
+  recording which entries have been computed.  A lookup is just an
+  index computation (one multiply-add per dimension) and a bit test,
+  with no comparisons, hashing, or pointer chasing.
+
+  The key is an integer for a one-dimensional table, or else a
+  std::array of N integers.  Bounds on each dimension are given at
+  construction.  Keys outside the bounds are valid, but are simply
+  never cached.
+
+  Ex:
+    // table for 0<=j1<=10, 0<=j2<=10, -20<=m<=20
+    typedef mcutils::DenseMemoizer<double,3> memoizer_type;
+    static memoizer_type m({0,0,-20},{10,10,20});
+    double y = MEMOIZE(m, (memoizer_type::key_type{j1,j2,m}), f(j1,j2,m));
+
+  Note the parentheses around the braced key, which keep its commas
+  from being taken as macro argument separators.
+
+  Memory: capacity()*sizeof(T) plus one bit per entry, allocated up
+  front.
+
+  - 10/17/26: Created.
+
+****************************************************************/
+
+#ifndef MCUTILS_DENSE_MEMOIZER_H_
+#define MCUTILS_DENSE_MEMOIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "memoizer.h"
+
+namespace mcutils
+{
+  ////////////////////////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////
+
+  template<typename T, std::size_t N = 1, typename Index = int>
+    class DenseMemoizer{
+
+    static_assert(N>=1, "DenseMemoizer requires at least one dimension");
+    static_assert(std::is_integral_v<Index>, "DenseMemoizer requires integral index type");
+
+    public:
+
+    ////////////////////////////////
+    // type definitions
+    ////////////////////////////////
+
+    typedef std::array<Index,N> index_array_type;
+    typedef std::conditional_t<N==1,Index,index_array_type> key_type;
+    typedef T mapped_type;
+    typedef std::size_t size_type;
+
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    // construct table for keys with lower<=x[i]<=upper[i] in each dimension
+    //   enable or disable caching
+    DenseMemoizer(const index_array_type& lower, const index_array_type& upper, bool b = true);
+
+    // construct one-dimensional table for keys with lower<=x<=upper
+    template<std::size_t NX = N, typename std::enable_if_t<NX==1>* = nullptr>
+      DenseMemoizer(Index lower, Index upper, bool b = true)
+      : DenseMemoizer(index_array_type{lower},index_array_type{upper},b)
+    {};
+
+    ////////////////////////////////
+    // accessors
+    ////////////////////////////////
+
+    // Seek(x) seeks entry for key x, returns true if found
+    //   as side effect, saves location of "y" value for subsequent
+    //   rapid access by GetValue()
+    bool Seek(const key_type& x)
+    {
+      current_index_ = FlatIndex(x);
+      return cache_enabled_ && (current_index_!=kOutOfRange) && IsValid(current_index_);
+    };
+
+    // GetValue() returns the "y" value for
+    //   the most recently sought key
+    //   note: this requires that no recursive call be made
+    //   before GetValue() invoked
+    T GetValue() const {return values_[current_index_];};
+
+    // SetValue(y) stores y value (if x lies within bounds)
+    //   and returns a copy of this value
+    T SetValue(const key_type& x, const T& y);
+
+    // GetOrEmplace(x,f) returns reference to the "y" value for key x,
+    //   first storing f() as this value if x is not yet known
+    //
+    //   If x is out of bounds or caching is disabled, f() is stored in
+    //   a scratch value, which is overwritten by the next call.
+    template<typename F>
+      const T& GetOrEmplace(const key_type& x, F&& f);
+
+    // Known(x) determines whether or not a value for x is already stored
+    //   for debugging and diagnostic use -- not part of MEMOIZE call
+    bool Known(const key_type& x) const
+    {
+      size_type i = FlatIndex(x);
+      return (i!=kOutOfRange) && IsValid(i);
+    };
+
+    // InRange(x) determines whether or not key x lies within table bounds
+    bool InRange(const key_type& x) const {return FlatIndex(x)!=kOutOfRange;};
+
+    ////////////////////////////////
+    // bulk access
+    ////////////////////////////////
+
+    // number of stored entries
+    size_type size() const {return size_;};
+
+    // number of table cells (maximum number of entries)
+    size_type capacity() const {return values_.size();};
+
+    // clear() marks all entries as unknown (storage is retained)
+    void clear()
+    {
+      std::fill(valid_.begin(),valid_.end(),0);
+      size_ = 0;
+    };
+
+    // bounds
+    const index_array_type& lower() const {return lower_;};
+    const index_array_type& upper() const {return upper_;};
+
+    ////////////////////////////////
+    // ostream output
+    ////////////////////////////////
+
+    // output operator -- friend declaration for access to delimiters
+    template<typename TX, std::size_t NX, typename IndexX>
+    friend std::ostream& operator<< (std::ostream&, const DenseMemoizer<TX,NX,IndexX>&);
+
+    ////////////////////////////////
+    // configuration
+    ////////////////////////////////
+
+    // mode flags
+    void EnableCaching(bool b) {cache_enabled_ = b;};
+
+    // configuring delimiter strings
+    //   static member function sets delimiters for *all* DenseMemoizer
+    //   instances with the given template parameters
+    static void SetDelimiters(const std::string&, const std::string&, const std::string&);
+
+    private:
+
+    ////////////////////////////////
+    // indexing
+    ////////////////////////////////
+
+    typedef std::make_unsigned_t<Index> unsigned_index_type;
+
+    // sentinel for out-of-bounds key
+    static constexpr size_type kOutOfRange = static_cast<size_type>(-1);
+
+    // FlatIndex(x) returns position of key x in flat array, or kOutOfRange
+    //
+    // Each coordinate is offset by its lower bound and compared to its
+    // extent as an unsigned integer, so that both the lower and upper
+    // bound checks become a single comparison.  The checks for all
+    // dimensions are combined without branching.
+    size_type FlatIndex(const key_type& x) const
+    {
+      size_type index = 0;
+      bool in_range = true;
+      for (std::size_t d=0; d<N; ++d)
+        {
+          const unsigned_index_type offset = static_cast<unsigned_index_type>(Coordinate(x,d))-static_cast<unsigned_index_type>(lower_[d]);
+          in_range &= (offset<extents_[d]);
+          index += static_cast<size_type>(offset)*strides_[d];
+        }
+      return in_range ? index : kOutOfRange;
+    };
+
+    // KeyForIndex(i) returns key at position i in flat array
+    key_type KeyForIndex(size_type index) const
+    {
+      key_type x{};
+      for (std::size_t d=0; d<N; ++d)
+        {
+          Coordinate(x,d) = static_cast<Index>(lower_[d]+static_cast<Index>(index/strides_[d]));
+          index %= strides_[d];
+        }
+      return x;
+    };
+
+    static Index Coordinate(const key_type& x, std::size_t d)
+    {
+      if constexpr (N==1)
+        return x;
+      else
+        return x[d];
+    };
+    static Index& Coordinate(key_type& x, std::size_t d)
+    {
+      if constexpr (N==1)
+        return x;
+      else
+        return x[d];
+    };
+
+    // validity bitmap access
+    bool IsValid(size_type i) const {return (valid_[i/64]>>(i%64))&1;};
+    void MarkValid(size_type i)
+    {
+      valid_[i/64] |= (std::uint64_t(1)<<(i%64));
+      ++size_;
+    };
+
+    ////////////////////////////////
+    // configuration data
+    ////////////////////////////////
+
+    // ostream delimiters (static)
+    static std::string delimiter_left_;
+    static std::string delimiter_middle_;
+    static std::string delimiter_right_;
+
+    // mode variables
+    bool cache_enabled_;
+
+    // bounds
+    index_array_type lower_, upper_;
+    std::array<size_type,N> extents_, strides_;
+
+    ////////////////////////////////
+    // caching data
+    ////////////////////////////////
+
+    // values, in row-major order (last dimension varies fastest)
+    std::vector<T> values_;
+
+    // validity bitmap
+    std::vector<std::uint64_t> valid_;
+    size_type size_;
+
+    // current entry access
+    size_type current_index_ = kOutOfRange;
+
+    // scratch value for GetOrEmplace with key out of range
+    std::optional<T> scratch_result_;
+
+  };
+
+  template<typename T, std::size_t N, typename Index>
+    DenseMemoizer<T,N,Index>::DenseMemoizer(
+        const index_array_type& lower, const index_array_type& upper, bool b
+      )
+      : cache_enabled_(b), lower_(lower), upper_(upper), size_(0)
+    {
+      size_type capacity = 1;
+      for (std::size_t d=N; d-->0;)
+        {
+          extents_[d] = (upper_[d]>=lower_[d]) ? static_cast<size_type>(upper_[d]-lower_[d])+1 : 0;
+          strides_[d] = capacity;
+          capacity *= extents_[d];
+        }
+      // guard against division by zero in KeyForIndex for empty tables
+      for (std::size_t d=0; d<N; ++d)
+        if (strides_[d]==0)
+          strides_[d] = 1;
+      values_.resize(capacity);
+      valid_.assign((capacity+63)/64,0);
+    }
+
+  template<typename T, std::size_t N, typename Index>
+    inline
+    T DenseMemoizer<T,N,Index>::SetValue(const key_type& x, const T& y)
+    {
+      if (cache_enabled_)
+        {
+          // existing entry is retained, as for Memoizer
+          size_type i = FlatIndex(x);
+          if ((i!=kOutOfRange) && !IsValid(i))
+            {
+              values_[i] = y;
+              MarkValid(i);
+            }
+        }
+
+      return y;
+    }
+
+  template<typename T, std::size_t N, typename Index>
+    template<typename F>
+    inline
+    const T& DenseMemoizer<T,N,Index>::GetOrEmplace(const key_type& x, F&& f)
+    {
+      size_type i = FlatIndex(x);
+      if (!cache_enabled_ || (i==kOutOfRange))
+        {
+          scratch_result_.emplace(std::forward<F>(f)());
+          return *scratch_result_;
+        }
+
+      if (!IsValid(i))
+        {
+          // storage is preallocated, so a recursive call from f()
+          // cannot invalidate position i
+          T y(std::forward<F>(f)());
+          if (!IsValid(i))
+            {
+              values_[i] = std::move(y);
+              MarkValid(i);
+            }
+        }
+      return values_[i];
+    }
+
+  ////////////////////////////////
+  // stream output
+  ////////////////////////////////
+
+  // initialize delimiter variables
+  template<typename T, std::size_t N, typename Index>
+    std::string DenseMemoizer<T,N,Index>::delimiter_left_("  ");
+  template<typename T, std::size_t N, typename Index>
+    std::string DenseMemoizer<T,N,Index>::delimiter_middle_("->");
+  template<typename T, std::size_t N, typename Index>
+    std::string DenseMemoizer<T,N,Index>::delimiter_right_("\n");
+
+  // delimiter configuration
+  template<typename T, std::size_t N, typename Index>
+    void DenseMemoizer<T,N,Index>::SetDelimiters(
+        const std::string& left,
+        const std::string& middle,
+        const std::string& right
+      )
+    {
+      DenseMemoizer<T,N,Index>::delimiter_left_ = left;
+      DenseMemoizer<T,N,Index>::delimiter_middle_ = middle;
+      DenseMemoizer<T,N,Index>::delimiter_right_ = right;
+    };
+
+  // output operator
+  //   entries are listed in key (lexicographic) order, with
+  //   multidimensional keys written as (x0,x1,...)
+  template<typename T, std::size_t N, typename Index>
+    std::ostream& operator<< (std::ostream& os, const DenseMemoizer<T,N,Index>& m)
+  {
+    typedef DenseMemoizer<T,N,Index> memoizer_type;
+    for (typename memoizer_type::size_type i=0; i<m.capacity(); ++i)
+      {
+        if (!m.IsValid(i))
+          continue;
+        typename memoizer_type::key_type x = m.KeyForIndex(i);
+        os << memoizer_type::delimiter_left_;
+        if constexpr (N==1)
+          os << x;
+        else
+          {
+            os << "(";
+            for (std::size_t d=0; d<N; ++d)
+              os << (d ? "," : "") << x[d];
+            os << ")";
+          }
+        os << memoizer_type::delimiter_middle_;
+        os << m.values_[i];
+        os << memoizer_type::delimiter_right_;
+      }
+
+    return os;
+  }
+
+}  // namespace
+
+#endif
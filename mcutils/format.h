@@ -0,0 +1,76 @@
+/****************************************************************
+  format.h
+
+  Formatting of mcutils types with the {fmt} library.
+
+  Requires: fmt
+
+  Provides fmt::formatter specializations, so that VectorTuple and
+  Memoizer may be used as fmt::format arguments:
+
+    fmt::print("{} {}\n", tuple, memoizer);
+
+  The text is generated through the mcutils::TextFormatter machinery
+  (see io.h), with the same layout and configured delimiters as for the
+  ostream output operator.  However, numbers are converted by
+  std::to_chars, so floating point values are written in shortest
+  round-trip form, rather than to the (default six digit) stream
+  precision, e.g., 0.1+0.2 gives "0.30000000000000004" rather than
+  "0.3".  Integer and exactly representable short values give the same
+  text by either path.  No format specification is accepted.
+
+  + 10/17/26: Created.
+  + 10/17/26: Correct description of floating point output.
+
+****************************************************************/
+
+#ifndef MCUTILS_FORMAT_H_
+#define MCUTILS_FORMAT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "io.h"
+#include "memoizer.h"
+#include "vector_tuple.h"
+
+namespace mcutils
+{
+  namespace impl
+  {
+    template<typename T>
+      struct TextFormatterAdaptor
+      // Adaptor from TextFormatter<T> to fmt::formatter interface.
+      {
+        template<typename ParseContext>
+          constexpr auto parse(ParseContext& ctx) -> decltype(ctx.begin())
+        {
+          return ctx.begin();
+        }
+
+        template<typename FormatContext>
+          auto format(const T& value, FormatContext& ctx) const -> decltype(ctx.out())
+        {
+          thread_local std::string buffer;
+          buffer.clear();
+          TextFormatter<T>::Append(buffer,value);
+          return std::copy(buffer.begin(),buffer.end(),ctx.out());
+        }
+      };
+  }  // namespace impl
+}  // namespace mcutils
+
+template<class T, std::size_t N, std::size_t B>
+struct fmt::formatter<mcutils::VectorTuple<T,N,B>>
+  : mcutils::impl::TextFormatterAdaptor<mcutils::VectorTuple<T,N,B>>
+{};
+
+template<typename Key, typename T, typename Compare, typename Alloc>
+struct fmt::formatter<mcutils::Memoizer<Key,T,Compare,Alloc>>
+  : mcutils::impl::TextFormatterAdaptor<mcutils::Memoizer<Key,T,Compare,Alloc>>
+{};
+
+#endif
@@ -0,0 +1,396 @@
+/****************************************************************
+
+  frozen_memoizer.h
+
+  Read-only memoizer table, and parallel precomputation of tables
+  over a known key domain.
+
+  For functions whose key domain is known ahead of time, it is
+  cheaper to evaluate the function over the whole domain up front,
+  in parallel, than to pay the miss penalty inside hot loops:
+
+    std::vector<Key> keys = ...;
+    auto table = mcutils::Precompute(keys, [](const Key& x){return f(x);}, 0);
+    ...
+    #pragma omp parallel for
+    for (...)
+      y += *table.Find(x);
+
+  The resulting FrozenMemoizer stores its entries as a pair of
+  sorted arrays (keys and values).  It is built in a single bulk pass,
+  with one allocation per array, and, since it is never modified
+  after construction, lookups are lock free and safe to make from any
+  number of threads.
+
+  A Memoizer which has been filled during a build phase, and is only
+  read thereafter, may likewise be compacted into a FrozenMemoizer, by
+  Memoizer::Freeze().  A Memoizer snapshot file may be loaded directly
+  into a FrozenMemoizer, by LoadFrozenSnapshot() (see memoizer.h).
+
+  - 10/17/26: Created.
+  - 10/17/26: Add branchless lookup, iteration, and stream output, and
+    Memoizer::Freeze().
+  - 10/17/26: Reject bool values, and join started threads if thread
+    creation fails in Precompute.
+
+****************************************************************/
+
+#ifndef MCUTILS_FROZEN_MEMOIZER_H_
+#define MCUTILS_FROZEN_MEMOIZER_H_
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mcutils
+{
+  ////////////////////////////////////////////////////////////////
+  // FrozenMemoizer
+  ////////////////////////////////////////////////////////////////
+
+  template<typename Key, typename T, typename Compare = std::less<Key> >
+    class FrozenMemoizer{
+
+    // values are stored in std::vector<T>, which for bool is bit packed,
+    //   so it could not return pointers to values (Find) or be filled
+    //   concurrently (Precompute)
+    static_assert(
+        !std::is_same_v<T,bool>,
+        "FrozenMemoizer does not support bool values (use, e.g., char or std::uint8_t)"
+      );
+
+    public:
+
+    ////////////////////////////////
+    // type definitions
+    ////////////////////////////////
+
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef Compare key_compare;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    // entries are stored as separate key and value arrays, so iteration
+    //   yields (key,value) reference pairs rather than references to
+    //   stored pairs
+    typedef std::pair<const Key&,const T&> const_reference;
+
+    class const_iterator;
+
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    // default -- empty table
+    FrozenMemoizer() = default;
+
+    // construct from key and value arrays
+    //   keys must be sorted (according to Compare) and distinct,
+    //   with values[i] the value for keys[i]
+    FrozenMemoizer(std::vector<Key> keys, std::vector<T> values, const Compare& compare = Compare())
+      : keys_(std::move(keys)), values_(std::move(values)), compare_(compare)
+    {};
+
+    ////////////////////////////////
+    // accessors
+    ////////////////////////////////
+
+    // Find(x) returns pointer to the value for key x, or nullptr if
+    //   x is not in the table
+    const T* Find(const Key& x) const
+    {
+      size_type i = LowerBound(x);
+      if ((i==keys_.size()) || compare_(x,keys_[i]))
+        return nullptr;
+      return &values_[i];
+    };
+
+    // Known(x) determines whether or not a value for x is stored
+    bool Known(const Key& x) const {return Find(x)!=nullptr;};
+
+    // GetOrCompute(x,f) returns the value for key x, or else f() if x
+    //   is not in the table (without storing it)
+    template<typename F>
+      T GetOrCompute(const Key& x, F&& f) const
+    {
+      const T* value_ptr = Find(x);
+      return value_ptr ? *value_ptr : std::forward<F>(f)();
+    };
+
+    ////////////////////////////////
+    // iterators
+    ////////////////////////////////
+
+    // iteration is in key order, as for Memoizer
+
+    const_iterator begin() const {return const_iterator(this,0);};
+    const_iterator end() const {return const_iterator(this,size());};
+
+    ////////////////////////////////
+    // bulk access
+    ////////////////////////////////
+
+    size_type size() const {return keys_.size();};
+
+    // sorted key array, and corresponding value array
+    const std::vector<Key>& keys() const {return keys_;};
+    const std::vector<T>& values() const {return values_;};
+
+    ////////////////////////////////
+    // ostream output
+    ////////////////////////////////
+
+    // output operator -- friend declaration for access to delimiters
+    template<typename KeyX, typename TX, typename CompareX>
+    friend std::ostream& operator<< (std::ostream&, const FrozenMemoizer<KeyX,TX,CompareX>&);
+
+    // configuring delimiter strings
+    //   static member function sets delimiters for *all* FrozenMemoizer
+    //   instances with the given template parameters
+    static void SetDelimiters(const std::string&, const std::string&, const std::string&);
+
+    private:
+
+    ////////////////////////////////
+    // search
+    ////////////////////////////////
+
+    // LowerBound(x) returns index of first key not less than x
+    //
+    // Branchless binary search: each step halves the search range by
+    // conditionally advancing its base, which compiles to a conditional
+    // move rather than an unpredictable branch (for scalar keys), and
+    // the number of steps depends only on the table size.  Lookups in a
+    // large table are then limited by memory latency rather than by
+    // branch mispredictions.  (The sorted layout is retained, rather
+    // than an Eytzinger layout, so that iteration stays in key order.)
+    size_type LowerBound(const Key& x) const
+    {
+      size_type n = keys_.size();
+      if (n==0)
+        return 0;
+      const Key* base = keys_.data();
+      while (n>1)
+        {
+          const size_type half = n/2;
+          base = compare_(base[half],x) ? base+half : base;
+          n -= half;
+        }
+      return static_cast<size_type>(base-keys_.data())+(compare_(*base,x) ? 1 : 0);
+    };
+
+    ////////////////////////////////
+    // data
+    ////////////////////////////////
+
+    // ostream delimiters (static)
+    static std::string delimiter_left_;
+    static std::string delimiter_middle_;
+    static std::string delimiter_right_;
+
+    // entries
+    std::vector<Key> keys_;
+    std::vector<T> values_;
+    Compare compare_;
+
+  };
+
+  ////////////////////////////////
+  // iterator
+  ////////////////////////////////
+
+  template<typename Key, typename T, typename Compare>
+    class FrozenMemoizer<Key,T,Compare>::const_iterator
+    {
+      public:
+
+      typedef std::input_iterator_tag iterator_category;
+      typedef std::pair<const Key&,const T&> value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef value_type reference;
+
+      // pointer proxy, for it->first and it->second
+      struct pointer
+      {
+        value_type entry;
+        const value_type* operator->() const {return &entry;};
+      };
+
+      const_iterator() = default;
+      const_iterator(const FrozenMemoizer* table, size_type index)
+        : table_(table), index_(index)
+      {};
+
+      reference operator*() const {return reference(table_->keys_[index_],table_->values_[index_]);};
+      pointer operator->() const {return pointer{**this};};
+
+      const_iterator& operator++() {++index_; return *this;};
+      const_iterator operator++(int) {const_iterator old = *this; ++index_; return old;};
+
+      bool operator==(const const_iterator& other) const {return index_==other.index_;};
+      bool operator!=(const const_iterator& other) const {return index_!=other.index_;};
+
+      private:
+
+      const FrozenMemoizer* table_ = nullptr;
+      size_type index_ = 0;
+    };
+
+  ////////////////////////////////
+  // stream output
+  ////////////////////////////////
+
+  // initialize delimiter variables
+  //   (defaults are as for Memoizer)
+  template<typename Key, typename T, typename Compare>
+    std::string FrozenMemoizer<Key,T,Compare>::delimiter_left_("  ");
+  template<typename Key, typename T, typename Compare>
+    std::string FrozenMemoizer<Key,T,Compare>::delimiter_middle_("->");
+  template<typename Key, typename T, typename Compare>
+    std::string FrozenMemoizer<Key,T,Compare>::delimiter_right_("\n");
+
+  // delimiter configuration
+  template<typename Key, typename T, typename Compare>
+    void FrozenMemoizer<Key,T,Compare>::SetDelimiters(
+        const std::string& left,
+        const std::string& middle,
+        const std::string& right
+      )
+    {
+      FrozenMemoizer<Key,T,Compare>::delimiter_left_ = left;
+      FrozenMemoizer<Key,T,Compare>::delimiter_middle_ = middle;
+      FrozenMemoizer<Key,T,Compare>::delimiter_right_ = right;
+    };
+
+  // output operator
+  template<typename Key, typename T, typename Compare>
+    std::ostream& operator<< (std::ostream& os, const FrozenMemoizer<Key,T,Compare>& m)
+  {
+    typedef FrozenMemoizer<Key,T,Compare> memoizer_type;
+    for (typename memoizer_type::size_type i=0; i<m.size(); ++i)
+      {
+        os << memoizer_type::delimiter_left_;
+        os << m.keys_[i];
+        os << memoizer_type::delimiter_middle_;
+        os << m.values_[i];
+        os << memoizer_type::delimiter_right_;
+      }
+
+    return os;
+  }
+
+  ////////////////////////////////////////////////////////////////
+  // parallel precomputation
+  ////////////////////////////////////////////////////////////////
+
+  template<typename KeyRange, typename F>
+    auto Precompute(const KeyRange& key_range, F&& f, int num_threads)
+    // Evaluate function on each key in domain, in parallel, and freeze
+    // the results into a read-only table.
+    //
+    // Duplicate keys in the domain are evaluated only once.  The keys
+    // are sorted first, so the table is built directly in its final
+    // order, with no per-entry insertion.  Work is handed out to the
+    // threads in small chunks, for load balance when the cost of f
+    // varies across the domain.
+    //
+    // The functor is invoked concurrently from several threads, so it
+    // must be thread safe.  If it throws, the first exception is
+    // rethrown here after all threads have finished.
+    //
+    // Template arguments:
+    //   KeyRange: container or range of keys (anything with begin/end)
+    //   F: functor taking const Key& and returning value
+    //
+    // Arguments:
+    //   key_range (input): key domain
+    //   f (input): function to tabulate
+    //   num_threads (input): number of threads (0 for hardware concurrency)
+    //
+    // Returns:
+    //   (FrozenMemoizer<Key,T>): table of f over domain, where T is the
+    //     (decayed) return type of f, which must be default constructible
+    {
+      typedef std::decay_t<decltype(*std::begin(key_range))> key_type;
+      typedef std::decay_t<std::invoke_result_t<F&,const key_type&>> value_type;
+      static_assert(
+          !std::is_same_v<value_type,bool>,
+          "Precompute does not support functions returning bool (return, e.g., char or std::uint8_t)"
+        );
+
+      // collect sorted, distinct keys
+      std::vector<key_type> keys(std::begin(key_range),std::end(key_range));
+      std::sort(keys.begin(),keys.end());
+      keys.erase(std::unique(keys.begin(),keys.end()),keys.end());
+
+      // evaluate values
+      if (num_threads <= 0)
+        num_threads = std::max(1u,std::thread::hardware_concurrency());
+      const std::size_t num_keys = keys.size();
+      const std::size_t chunk_size = 64;
+      std::vector<value_type> values(num_keys);
+      std::atomic<std::size_t> next_chunk(0);
+      std::exception_ptr exception;
+      std::mutex exception_mutex;
+      auto worker = [&]()
+        {
+          try
+            {
+              for (
+                  std::size_t begin = next_chunk.fetch_add(chunk_size);
+                  begin < num_keys;
+                  begin = next_chunk.fetch_add(chunk_size)
+                )
+                {
+                  const std::size_t end = std::min(begin+chunk_size,num_keys);
+                  for (std::size_t i=begin; i<end; ++i)
+                    values[i] = f(keys[i]);
+                }
+            }
+          catch (...)
+            {
+              std::lock_guard<std::mutex> lock(exception_mutex);
+              if (!exception)
+                exception = std::current_exception();
+              // stop other threads from taking more work
+              next_chunk = num_keys;
+            }
+        };
+
+      std::vector<std::thread> threads;
+      try
+        {
+          for (int t=1; t<num_threads; ++t)
+            threads.emplace_back(worker);
+        }
+      catch (...)
+        {
+          // threads already started must be joined before they are destroyed
+          next_chunk = num_keys;
+          for (auto& thread : threads)
+            thread.join();
+          throw;
+        }
+      worker();
+      for (auto& thread : threads)
+        thread.join();
+      if (exception)
+        std::rethrow_exception(exception);
+
+      return FrozenMemoizer<key_type,value_type>(std::move(keys),std::move(values));
+    }
+
+}  // namespace
+
+#endif
@@ -8,7 +8,17 @@
 
 #include "io.h"
 
+#include <fstream>
 #include <iostream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MCUTILS_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace mcutils
 {
@@ -36,4 +46,88 @@ IOMode DeducedIOMode(const std::string& filename)
     exit(EXIT_FAILURE);
   }
 }
+
+////////////////////////////////////////////////////////////////
+// memory-mapped file access
+////////////////////////////////////////////////////////////////
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other)
+  {
+    close();
+    is_open_ = std::exchange(other.is_open_, false);
+    is_mapped_ = std::exchange(other.is_mapped_, false);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+    if (!is_mapped_)
+      data_ = buffer_.data();
+  }
+  return *this;
+}
+
+bool MappedFile::open(const std::string& filename)
+{
+  close();
+
+#ifdef MCUTILS_HAVE_MMAP
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (::fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+  if (size_ > 0)
+  {
+    void* ptr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+      ::close(fd);
+      size_ = 0;
+      return false;
+    }
+    ::madvise(ptr, size_, MADV_WILLNEED);
+    data_ = static_cast<const char*>(ptr);
+    is_mapped_ = true;
+  }
+  // mapping remains valid after descriptor is closed
+  ::close(fd);
+#else
+  std::ifstream is(filename, std::ios_base::in | std::ios_base::binary);
+  if (!is)
+    return false;
+  is.seekg(0, std::ios_base::end);
+  buffer_.resize(static_cast<std::size_t>(is.tellg()));
+  is.seekg(0, std::ios_base::beg);
+  is.read(buffer_.data(), buffer_.size());
+  if (!is)
+  {
+    buffer_.clear();
+    return false;
+  }
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+#endif
+
+  is_open_ = true;
+  return true;
+}
+
+void MappedFile::close()
+{
+#ifdef MCUTILS_HAVE_MMAP
+  if (is_mapped_)
+    ::munmap(const_cast<char*>(data_), size_);
+#endif
+  buffer_.clear();
+  is_open_ = is_mapped_ = false;
+  data_ = nullptr;
+  size_ = 0;
+}
+
 };  // namespace mcutils
@@ -13,14 +13,24 @@
   + 06/01/23 (pjf):
     - Remove default count from WriteBinary and ReadBinary.
     - Use static_assert to prevent reading/writing pointer values.
+  + 10/17/26: Add MappedFile for read-only memory-mapped file access.
+  + 10/17/26: Add TextFormatter, AppendText, and TextWriter for fast
+    buffered text output.
 
 ****************************************************************/
 
 #ifndef MCUTILS_IO_H_
 #define MCUTILS_IO_H_
 
+#include <cstddef>
+#include <charconv>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace mcutils
 {
@@ -139,6 +149,203 @@ namespace mcutils
 
   IOMode DeducedIOMode(const std::string& filename);
 
+  ////////////////////////////////////////////////////////////////
+  // memory-mapped file access
+  ////////////////////////////////////////////////////////////////
+
+  class MappedFile
+  // Read-only view of a file's contents.
+  //
+  // On POSIX systems, the file is memory mapped, so pages are only
+  // read from disk (or page cache) as they are touched, and no copy
+  // into a user-space buffer is made.  Elsewhere, the contents are
+  // read into an internal buffer.
+  //
+  // Failure to open or map the file is not fatal; check is_open().
+  //
+  // Ex:
+  //   mcutils::MappedFile file(filename);
+  //   if (file.is_open())
+  //     ... use file.data()[0..file.size()-1] ...
+  {
+    public:
+
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename) {open(filename);};
+    ~MappedFile() {close();};
+
+    // movable but not copyable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept {*this = std::move(other);};
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // open(filename) maps file, returning true on success
+    bool open(const std::string& filename);
+
+    // close() unmaps file
+    void close();
+
+    bool is_open() const {return is_open_;};
+    const char* data() const {return data_;};
+    std::size_t size() const {return size_;};
+
+    private:
+
+    bool is_open_ = false;
+    bool is_mapped_ = false;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    // fallback storage, if memory mapping is not available
+    std::vector<char> buffer_;
+  };
+
+  ////////////////////////////////////////////////////////////////
+  // fast text output
+  ////////////////////////////////////////////////////////////////
+
+  // Text output through iostream insertion makes several virtual calls
+  // and locale lookups per value.  For bulk output (e.g., dumping large
+  // tables), values may instead be appended to a character buffer,
+  // which is written to the stream in large blocks:
+  //
+  //   mcutils::TextWriter writer(os);
+  //   for (...)
+  //     writer << key << " " << value << "\n";
+  //
+  // Numbers are converted by std::to_chars, which is locale independent
+  // and does not allocate.  Note that floating point values are written
+  // in shortest round-trip form, rather than to the (default six digit)
+  // stream precision.
+  //
+  // The text representation of a type is defined by specializing
+  // TextFormatter.  Types without a specialization fall back to
+  // iostream insertion.
+
+  template<typename T, typename Enable = void>
+    struct TextFormatter
+    // Fallback: text from ostream insertion operator.
+    {
+      static void Append(std::string& buffer, const T& value)
+      {
+        thread_local std::ostringstream os;
+        os.str("");
+        os << value;
+        buffer += os.str();
+      }
+    };
+
+  template<typename T>
+    struct TextFormatter<
+        T,
+        std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T,bool> && !std::is_same_v<T,char>>
+      >
+    // Numbers: text from std::to_chars.
+    {
+      static void Append(std::string& buffer, T value)
+      {
+        char chars[64];
+        std::to_chars_result result = std::to_chars(chars,chars+sizeof(chars),value);
+        buffer.append(chars,result.ptr);
+      }
+    };
+
+  template<>
+    struct TextFormatter<char>
+    {
+      static void Append(std::string& buffer, char value) {buffer += value;}
+    };
+
+  template<>
+    struct TextFormatter<std::string>
+    {
+      static void Append(std::string& buffer, const std::string& value) {buffer += value;}
+    };
+
+  template<>
+    struct TextFormatter<std::string_view>
+    {
+      static void Append(std::string& buffer, std::string_view value) {buffer += value;}
+    };
+
+  template<typename T>
+    void AppendText(std::string& buffer, const T& value)
+    // Append text representation of value to buffer.
+    {
+      TextFormatter<T>::Append(buffer,value);
+    }
+
+  inline void AppendText(std::string& buffer, const char* value)
+  {
+    buffer += value;
+  }
+
+  class TextWriter
+  // Buffered text output to stream.
+  //
+  // Text is accumulated in a buffer, which is written to the stream
+  // once it reaches the block size, and on destruction (or Flush()).
+  {
+    public:
+
+    explicit TextWriter(std::ostream& os, std::size_t block_size = 1<<16)
+      : os_(os), block_size_(block_size)
+    {
+      buffer_.reserve(block_size_+256);
+    };
+    ~TextWriter() {Flush();};
+
+    TextWriter(const TextWriter&) = delete;
+    TextWriter& operator=(const TextWriter&) = delete;
+
+    // append text representation of value
+    template<typename T>
+      TextWriter& operator<<(const T& value)
+    {
+      AppendText(buffer_,value);
+      Commit();
+      return *this;
+    };
+
+    // buffer, for direct appending (follow with call to Commit)
+    std::string& buffer() {return buffer_;};
+
+    // Commit() writes buffer to stream if block size has been reached
+    void Commit()
+    {
+      if (buffer_.size()>=block_size_)
+        Flush();
+    };
+
+    // Flush() writes buffer to stream
+    void Flush()
+    {
+      if (!buffer_.empty())
+        {
+          os_.write(buffer_.data(),buffer_.size());
+          buffer_.clear();
+        }
+    };
+
+    private:
+
+    std::ostream& os_;
+    std::size_t block_size_;
+    std::string buffer_;
+  };
+
+  template<typename T>
+    void WriteText(std::ostream& os, const T& value)
+    // Write text representation of value to stream.
+    //
+    // Overloads for containers (e.g., Memoizer) write their contents
+    // in blocks, without formatting the whole container in memory.
+    {
+      TextWriter writer(os);
+      writer << value;
+    }
+
 }  // namespace
 
 #endif
@@ -6,6 +6,24 @@
 
   Created by Mark A. Caprio, 2/23/11.
   - 6/9/17 (mac): Move into namespace mcutils.
+  - 10/17/26: Add HashMemoizer with open-addressing hash table storage.
+  - 10/17/26: Add single-lookup GetOrEmplace, with heterogeneous key
+    support, and avoid copying value on Seek.
+  - 10/17/26: Add binary snapshot save/restore for Memoizer.
+  - 10/17/26: Add optional hit/miss statistics and exit-time report.
+  - 10/17/26: Add Memoizer::Freeze() to compact into FrozenMemoizer.
+  - 10/17/26: Add TextFormatter specialization and WriteText for fast
+    text output of Memoizer.
+  - 10/17/26: Add LoadFrozenSnapshot to load snapshot directly into
+    FrozenMemoizer arrays.
+  - 10/17/26: Transfer statistics record on move, retire it on
+    destruction, and register exit report only once (thread safe).
+  - 10/17/26: Only grow HashMemoizer table on a miss, so that lookups
+    of existing keys never invalidate references.
+  - 10/17/26: Reject snapshot headers whose entry count would overflow
+    section size computation.
+  - 10/17/26: Time computation only around f() in GetOrEmplace, by
+    exception-safe guard.
 
 ****************************************************************/
 
@@ -13,11 +31,31 @@
 #define MCUTILS_MEMOIZER_H_
 
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
+#include "frozen_memoizer.h"
+#include "io.h"
+#include "meta.h"
+#include "parsing.h"
+
 // MEMOIZE(m,x,y) applies Memoizer m to key given by expression x
 //   - if x already exists as key, a const reference to the stored "y" 
 //     value for key x is returned
@@ -26,16 +64,435 @@
 // Optimization: Note key expression x is evaluated twice by the macro.
 // On the other hand, it cannot be saved within m, because of possible
 // reentrance problems if m is invoked in evaluating y.
+//
+// See also GetOrEmplace(x,f), which evaluates the key only once,
+// performs a single lookup, and returns a reference to the stored
+// value rather than a copy:
+//
+//   const T& y = m.GetOrEmplace(x,[&](){return ...;});
 
 #define MEMOIZE(m,x,y) ( (m.Seek(x)) ? m.GetValue() : m.SetValue(x,y) )
 
 
 namespace mcutils
 {
+  ////////////////////////////////////////////////////////////////
+  // snapshot file format
+  ////////////////////////////////////////////////////////////////
+
+  namespace impl
+  {
+    // Memoizer snapshot file layout:
+    //
+    //   header (MemoizerSnapshotHeader)
+    //   keys (count*key_size bytes, zero padded to multiple of kAlignment)
+    //   values (count*value_size bytes, zero padded to multiple of kAlignment)
+    //
+    // Entries are stored in key order, so that they may be reinserted
+    // into the map in linear time.
+    //
+    // The fingerprint is derived from the implementation's type names
+    // for Key and T, so a snapshot is only accepted by a Memoizer of the
+    // same type, as compiled by the same compiler.
+
+    struct MemoizerSnapshotHeader
+    {
+      static constexpr char kMagic[8] = {'M','C','M','E','M','O','I','Z'};
+      static constexpr std::uint32_t kVersion = 1;
+      static constexpr std::uint64_t kAlignment = 16;
+
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t alignment;
+      std::uint64_t fingerprint;
+      std::uint32_t key_size;
+      std::uint32_t value_size;
+      std::uint64_t count;
+      std::uint64_t reserved;
+    };
+    static_assert(sizeof(MemoizerSnapshotHeader)%MemoizerSnapshotHeader::kAlignment==0);
+
+    inline constexpr std::uint64_t SnapshotPaddedSize(std::uint64_t bytes)
+    {
+      const std::uint64_t alignment = MemoizerSnapshotHeader::kAlignment;
+      return ((bytes+alignment-1)/alignment)*alignment;
+    }
+
+    template<typename Key, typename T>
+      std::uint64_t MemoizerSnapshotFingerprint()
+      // FNV-1a hash of key and value type names and sizes.
+      {
+        std::uint64_t h = UINT64_C(0xcbf29ce484222325);
+        auto mix = [&h](const char* str, std::size_t n)
+          {
+            for (std::size_t i=0; i<n; ++i)
+              h = (h^static_cast<unsigned char>(str[i]))*UINT64_C(0x100000001b3);
+          };
+        const char* key_name = typeid(Key).name();
+        const char* value_name = typeid(T).name();
+        const std::uint64_t sizes[2] = {sizeof(Key),sizeof(T)};
+        mix(key_name,std::strlen(key_name)+1);
+        mix(value_name,std::strlen(value_name)+1);
+        mix(reinterpret_cast<const char*>(sizes),sizeof(sizes));
+        return h;
+      }
+
+    template<typename Key, typename T>
+      bool FindMemoizerSnapshotSections(
+          const MappedFile& file, const std::string& filename,
+          std::uint64_t& count, const char*& key_ptr, const char*& value_ptr
+        )
+      // Validate header of mapped snapshot file, and locate key and
+      // value sections.
+      //
+      // Returns false, with a warning, if the file is not a snapshot for
+      // this version and key/value type.
+      {
+        typedef MemoizerSnapshotHeader header_type;
+
+        // validate header
+        header_type header;
+        bool valid = (file.size() >= sizeof(header_type));
+        if (valid)
+          {
+            std::memcpy(&header,file.data(),sizeof(header_type));
+            valid = (std::memcmp(header.magic,header_type::kMagic,sizeof(header.magic)) == 0)
+              && (header.version == header_type::kVersion)
+              && (header.alignment == header_type::kAlignment)
+              && (header.fingerprint == MemoizerSnapshotFingerprint<Key,T>())
+              && (header.key_size == sizeof(Key))
+              && (header.value_size == sizeof(T));
+          }
+        // bound count by file size before computing section sizes, which
+        // could otherwise overflow and wrap to match the file size
+        valid = valid
+          && (header.count <= (file.size()-sizeof(header_type))/(sizeof(Key)+sizeof(T)));
+        const std::uint64_t key_section_size = valid ? SnapshotPaddedSize(header.count*sizeof(Key)) : 0;
+        const std::uint64_t value_section_size = valid ? SnapshotPaddedSize(header.count*sizeof(T)) : 0;
+        valid = valid && (file.size() == sizeof(header_type)+key_section_size+value_section_size);
+        if (!valid)
+          {
+            std::cerr << "WARN: ignoring incompatible or corrupt memoizer snapshot " << filename << std::endl;
+            return false;
+          }
+
+        count = header.count;
+        key_ptr = file.data()+sizeof(header_type);
+        value_ptr = key_ptr+key_section_size;
+        return true;
+      }
+  }  // namespace impl
+
+  ////////////////////////////////////////////////////////////////
+  // statistics
+  ////////////////////////////////////////////////////////////////
+
+  // Memoizer statistics are only collected if MCUTILS_MEMOIZER_STATISTICS
+  // is defined (e.g., by configuring with -DMCUTILS_MEMOIZER_STATISTICS=ON).
+  // Otherwise, the recording hooks are empty inline functions, and the
+  // statistics reported by each memoizer remain zero.
+  //
+  // The compute time is only measured for values computed through
+  // GetOrEmplace(x,f), as the time spent in f().  With Seek/SetValue
+  // (as in MEMOIZE), the computation is not delimited by the memoizer
+  // (a miss need not be followed by SetValue), so it is not timed.
+  //
+  // When enabled, every Memoizer and HashMemoizer registers its
+  // statistics record in a global registry.  A moved memoizer takes its
+  // record along with its entries.  When a memoizer is destroyed, its
+  // record is removed from the registry, and, if it was ever used, its
+  // counts are added to a retired total for its name (or for all
+  // unnamed memoizers).  So function-local static memoizers, which are
+  // destroyed at exit, may still be reported at program exit, while
+  // short-lived memoizers do not accumulate records:
+  //
+  //   mcutils::ReportMemoizerStatisticsAtExit();
+  //   ...
+  //   static mcutils::Memoizer<int,double> m;
+  //   m.SetName("sixj");
+
+  struct MemoizerStatistics
+  {
+    std::string name;
+    std::uint64_t lookups = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t inserts = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;  // estimated, excluding heap storage owned by values
+    double compute_time = 0.;  // seconds, inclusive of nested calls
+
+    double HitRate() const {return (lookups==0) ? 0. : static_cast<double>(hits)/lookups;};
+  };
+
+  void PrintMemoizerStatistics(std::ostream& os);
+  // Print table of statistics for all registered memoizers.
+
+  void ReportMemoizerStatisticsAtExit();
+  // Register PrintMemoizerStatistics(std::cout) to run at program exit.
+
+  namespace impl
+  {
+    struct MemoizerStatisticsRegistry
+    {
+      std::mutex mutex;
+      std::vector<std::shared_ptr<MemoizerStatistics>> records;  // live memoizers
+      std::vector<MemoizerStatistics> retired;  // totals for destroyed memoizers, by name
+      std::size_t num_registered = 0;
+    };
+
+    inline MemoizerStatisticsRegistry& GetMemoizerStatisticsRegistry()
+    // Access global registry.
+    //
+    // The registry is intentionally never destroyed, so that it is
+    // still available to exit-time reporting.
+    {
+      static MemoizerStatisticsRegistry* registry = new MemoizerStatisticsRegistry;
+      return *registry;
+    }
+
+#ifdef MCUTILS_MEMOIZER_STATISTICS
+
+    class MemoizerStatisticsRecorder
+    // Collects statistics for a single memoizer.
+    //
+    // The record is created (and registered) on first use, so that a
+    // moved-from memoizer which is used again gets a fresh record.
+    {
+      public:
+
+      MemoizerStatisticsRecorder()
+      {
+        Register();
+      };
+
+      // copy -- copied memoizer is a separate cache, so gets a new record
+      MemoizerStatisticsRecorder(const MemoizerStatisticsRecorder& other)
+        : MemoizerStatisticsRecorder()
+      {
+        record_->name = other.statistics().name + " (copy)";
+        named_ = other.named_;
+        record_->entries = other.statistics().entries;
+        record_->bytes = other.statistics().bytes;
+      };
+      MemoizerStatisticsRecorder& operator=(const MemoizerStatisticsRecorder& other)
+      {
+        record().entries = other.statistics().entries;
+        record().bytes = other.statistics().bytes;
+        return *this;
+      };
+
+      // move -- moved memoizer keeps its record
+      MemoizerStatisticsRecorder(MemoizerStatisticsRecorder&& other) noexcept
+        : record_(std::move(other.record_)), named_(other.named_),
+          compute_depth_(other.compute_depth_)
+      {};
+      MemoizerStatisticsRecorder& operator=(MemoizerStatisticsRecorder&& other) noexcept
+      {
+        if (this!=&other)
+          {
+            Unregister();
+            record_ = std::move(other.record_);
+            named_ = other.named_;
+            compute_depth_ = other.compute_depth_;
+          }
+        return *this;
+      };
+
+      ~MemoizerStatisticsRecorder()
+      {
+        Unregister();
+      };
+
+      void SetName(const std::string& name)
+      {
+        record().name = name;
+        named_ = true;
+      };
+      const MemoizerStatistics& statistics() const
+      {
+        static const MemoizerStatistics empty;
+        return record_ ? *record_ : empty;
+      };
+
+      void Lookup(bool hit)
+      {
+        MemoizerStatistics& r = record();
+        ++r.lookups;
+        ++(hit ? r.hits : r.misses);
+      };
+
+      void Insert(std::size_t entries, std::size_t bytes)
+      {
+        ++record().inserts;
+        Resize(entries,bytes);
+      };
+
+      void Resize(std::size_t entries, std::size_t bytes)
+      {
+        MemoizerStatistics& r = record();
+        r.entries = entries;
+        r.bytes = bytes;
+      };
+
+      // compute timing
+      //   the guard times its own scope, which is exited even if the
+      //   computation throws; intervals may be nested (through
+      //   recursive memoizer calls), and only the outermost interval
+      //   contributes, to avoid double counting
+      class ComputeGuard
+      {
+        public:
+        explicit ComputeGuard(MemoizerStatisticsRecorder& recorder)
+          : recorder_(recorder), start_time_(std::chrono::steady_clock::now())
+        {
+          ++recorder_.compute_depth_;
+        };
+        ComputeGuard(const ComputeGuard&) = delete;
+        ComputeGuard& operator=(const ComputeGuard&) = delete;
+        ~ComputeGuard()
+        {
+          if (--recorder_.compute_depth_==0)
+            {
+              std::chrono::duration<double> interval = std::chrono::steady_clock::now()-start_time_;
+              recorder_.record().compute_time += interval.count();
+            }
+        };
+        private:
+        MemoizerStatisticsRecorder& recorder_;
+        std::chrono::steady_clock::time_point start_time_;
+      };
+
+      private:
+
+      MemoizerStatistics& record()
+      {
+        if (!record_)
+          Register();
+        return *record_;
+      };
+
+      void Register()
+      {
+        record_ = std::make_shared<MemoizerStatistics>();
+        named_ = false;
+        MemoizerStatisticsRegistry& registry = GetMemoizerStatisticsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        record_->name = "memoizer" + std::to_string(registry.num_registered++);
+        registry.records.push_back(record_);
+      };
+
+      void Unregister()
+      // Remove record from registry, adding its counts to the retired
+      // total for its name.
+      {
+        if (!record_)
+          return;
+        MemoizerStatisticsRegistry& registry = GetMemoizerStatisticsRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = std::find(registry.records.begin(),registry.records.end(),record_);
+        if (it!=registry.records.end())
+          registry.records.erase(it);
+        if ((record_->lookups!=0) || (record_->inserts!=0))
+          {
+            const std::string name = named_ ? record_->name : std::string("(unnamed)");
+            auto retired_it = std::find_if(
+                registry.retired.begin(),registry.retired.end(),
+                [&name](const MemoizerStatistics& r) {return r.name==name;}
+              );
+            if (retired_it==registry.retired.end())
+              {
+                registry.retired.emplace_back();
+                retired_it = std::prev(registry.retired.end());
+                retired_it->name = name;
+              }
+            retired_it->lookups += record_->lookups;
+            retired_it->hits += record_->hits;
+            retired_it->misses += record_->misses;
+            retired_it->inserts += record_->inserts;
+            retired_it->entries += record_->entries;
+            retired_it->bytes += record_->bytes;
+            retired_it->compute_time += record_->compute_time;
+          }
+        record_.reset();
+      };
+
+      std::shared_ptr<MemoizerStatistics> record_;
+      bool named_ = false;
+      int compute_depth_ = 0;
+    };
+
+#else
+
+    class MemoizerStatisticsRecorder
+    // Null statistics recorder.
+    {
+      public:
+      void SetName(const std::string&) {};
+      const MemoizerStatistics& statistics() const
+      {
+        static const MemoizerStatistics empty;
+        return empty;
+      };
+      void Lookup(bool) {};
+      void Insert(std::size_t, std::size_t) {};
+      void Resize(std::size_t, std::size_t) {};
+      struct ComputeGuard
+      {
+        explicit ComputeGuard(MemoizerStatisticsRecorder&) {};
+      };
+    };
+
+#endif
+
+  }  // namespace impl
+
+  inline void PrintMemoizerStatistics(std::ostream& os)
+  {
+    impl::MemoizerStatisticsRegistry& registry = impl::GetMemoizerStatisticsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    os << "Memoizer statistics" << std::endl;
+    os << std::left << std::setw(24) << "name" << std::right
+       << std::setw(12) << "lookups"
+       << std::setw(12) << "hits"
+       << std::setw(12) << "misses"
+       << std::setw(8) << "hit%"
+       << std::setw(12) << "inserts"
+       << std::setw(12) << "entries"
+       << std::setw(12) << "MiB"
+       << std::setw(12) << "compute(s)"
+       << std::endl;
+    auto print_record = [&os](const MemoizerStatistics& record)
+      {
+        os << std::left << std::setw(24) << record.name << std::right
+           << std::setw(12) << record.lookups
+           << std::setw(12) << record.hits
+           << std::setw(12) << record.misses
+           << std::setw(8) << std::fixed << std::setprecision(1) << 100*record.HitRate()
+           << std::setw(12) << record.inserts
+           << std::setw(12) << record.entries
+           << std::setw(12) << std::setprecision(3) << record.bytes/1048576.
+           << std::setw(12) << std::setprecision(3) << record.compute_time
+           << std::defaultfloat << std::setprecision(6)
+           << std::endl;
+      };
+    for (const auto& record : registry.records)
+      print_record(*record);
+    for (const auto& record : registry.retired)
+      print_record(record);
+  }
+
+  inline void ReportMemoizerStatisticsAtExit()
+  {
+    static std::once_flag registered;
+    std::call_once(registered, [](){std::atexit([](){PrintMemoizerStatistics(std::cout);});});
+  }
+
   ////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////
 
-  template<typename Key, typename T, 
+  template<typename Key, typename T,
     typename Compare = std::less<Key> ,
     typename Alloc = std::allocator<std::pair<const Key, T> > >
     class Memoizer{
@@ -103,6 +560,23 @@ namespace mcutils
     //   and returns a copy of this value
     T SetValue(const Key& x, const T& y);
 
+    // GetOrEmplace(x,f) returns reference to the "y" value for key x,
+    //   first storing f() as this value if x is not yet known
+    //
+    //   Only a single tree descent is made: on a miss, the insertion
+    //   reuses the position found by the lookup, and the value returned
+    //   by f() is moved (not copied) into place.  The functor f may
+    //   itself invoke the memoizer recursively.
+    //
+    //   If the comparator is transparent (e.g., std::less<>), x may be
+    //   of any type comparable to Key, so that no temporary Key needs
+    //   to be constructed for a hit.
+    //
+    //   If caching is disabled, f() is stored in a scratch value,
+    //   which is overwritten by the next call.
+    template<typename K, typename F>
+      const T& GetOrEmplace(const K& x, F&& f);
+
     // Known(x) determines whether or not a value for x is already stored
     //   for debugging and diagnostic use -- not part of MEMOIZE call
     bool Known(const Key& x) const {return (values_.count(x) == 1);}
@@ -123,7 +597,47 @@ namespace mcutils
     ////////////////////////////////
 
     size_type size() const {return values_.size();};
-    void clear() {return values_.clear();};
+    void clear() {values_.clear(); statistics_.Resize(0,0);};
+
+    // Freeze() returns read-only copy of all entries, compacted into
+    //   sorted key and value arrays, for lookup after the table has
+    //   been filled (the memoizer itself is unchanged, and may be
+    //   cleared if no longer needed)
+    FrozenMemoizer<Key,T,Compare> Freeze() const;
+
+    ////////////////////////////////
+    // statistics
+    ////////////////////////////////
+
+    // statistics (all zero unless MCUTILS_MEMOIZER_STATISTICS defined)
+    const MemoizerStatistics& statistics() const {return statistics_.statistics();};
+
+    // name to identify memoizer in statistics report
+    void SetName(const std::string& name) {statistics_.SetName(name);};
+
+    ////////////////////////////////
+    // snapshot I/O
+    ////////////////////////////////
+
+    // SaveSnapshot(filename) writes all entries to binary snapshot file
+    //   requires Key and T to be trivially copyable
+    //   terminates with error message on file access failure
+    void SaveSnapshot(const std::string& filename) const;
+
+    // LoadSnapshot(filename) adds entries from binary snapshot file
+    //   The file is memory mapped, and entries are appended to the map
+    //   in a single linear pass.  Existing entries take precedence over
+    //   those in the snapshot.
+    //
+    //   Note that each entry is still reinserted as a map node, i.e.,
+    //   one allocation per entry.  If the table is only to be read
+    //   after loading, use LoadFrozenSnapshot instead, which copies the
+    //   sorted key and value sections directly into a FrozenMemoizer.
+    //
+    //   Returns false, leaving the memoizer unchanged, if the file does
+    //   not exist, or (with a warning) if it is not a snapshot for this
+    //   version and key/value type.
+    bool LoadSnapshot(const std::string& filename);
 
     ////////////////////////////////
     // ostream output
@@ -133,6 +647,10 @@ namespace mcutils
     template<typename KeyX, typename TX, typename CompareX, typename AllocX>
     friend std::ostream& operator<< (std::ostream&, const Memoizer<KeyX, TX, CompareX, AllocX>&);
 
+    // fast text output -- friend declaration for access to delimiters
+    template<typename, typename>
+    friend struct TextFormatter;
+
     ////////////////////////////////
     // configuration
     ////////////////////////////////
@@ -168,8 +686,17 @@ namespace mcutils
     map_type values_;
 
     // current entry access
-    // Key current_key_;
-    T current_result_;
+    //   pointer to value found by Seek (map nodes are stable)
+    const T* current_result_ = nullptr;
+
+    // scratch value for GetOrEmplace with caching disabled
+    std::optional<T> scratch_result_;
+
+    // statistics
+    impl::MemoizerStatisticsRecorder statistics_;
+
+    // estimated storage per map entry (value plus red-black tree node links)
+    static constexpr std::size_t kBytesPerEntry = sizeof(value_type)+4*sizeof(void*);
 
   };
 
@@ -188,14 +715,19 @@ namespace mcutils
           if ( it != values_.end()) 
             // key found
             {
-              // store associated "y" value for rapid access
-              current_result_ = it->second;
+              // store pointer to associated "y" value for rapid access
+              current_result_ = &(it->second);
+              statistics_.Lookup(true);
 			
               return true;
             }
           else
             // key not found
-            return false;
+            {
+              // value will be computed before call to SetValue
+              statistics_.Lookup(false);
+              return false;
+            }
 	}
       else
         // cache not enabled
@@ -207,7 +739,7 @@ namespace mcutils
     T Memoizer<Key,T,Compare,Alloc>::GetValue() const
     {
       // return "y" value
-      return current_result_;
+      return *current_result_;
     }
 
   template<typename Key, typename T, typename Compare, typename Alloc>
@@ -216,12 +748,186 @@ namespace mcutils
     {
       if (cache_enabled_)
 	{
-          values_.insert(value_type(x,y));
+          if (values_.insert(value_type(x,y)).second)
+            statistics_.Insert(values_.size(),values_.size()*kBytesPerEntry);
 	}
 
       return y;
     };
 
+  template<typename Key, typename T, typename Compare, typename Alloc>
+    template<typename K, typename F>
+    inline
+    const T& Memoizer<Key,T,Compare,Alloc>::GetOrEmplace(const K& x, F&& f)
+    {
+      if (!cache_enabled_)
+        {
+          scratch_result_.emplace(std::forward<F>(f)());
+          return *scratch_result_;
+        }
+
+      // look for key in map
+      //   lower_bound gives either the entry itself or the insertion
+      //   position for the new entry
+      iterator it = values_.lower_bound(x);
+      const bool hit = (it != values_.end()) && !values_.key_comp()(x,it->first);
+      statistics_.Lookup(hit);
+      if (hit)
+        return it->second;
+
+      // insert new entry at hinted position
+      //   the hint remains a valid iterator even if f() recursively
+      //   inserts entries (in which case emplace_hint falls back to a
+      //   full search)
+      const size_type old_size = values_.size();
+      {
+        impl::MemoizerStatisticsRecorder::ComputeGuard compute_guard(statistics_);
+        it = values_.emplace_hint(
+            it, std::piecewise_construct,
+            std::forward_as_tuple(x),
+            std::forward_as_tuple(std::forward<F>(f)())
+          );
+      }
+      if (values_.size() != old_size)
+        statistics_.Insert(values_.size(),values_.size()*kBytesPerEntry);
+      return it->second;
+    }
+
+  template<typename Key, typename T, typename Compare, typename Alloc>
+    FrozenMemoizer<Key,T,Compare> Memoizer<Key,T,Compare,Alloc>::Freeze() const
+    {
+      // map is already in key order, so arrays are filled by a single
+      // traversal
+      std::vector<Key> keys;
+      std::vector<T> values;
+      keys.reserve(values_.size());
+      values.reserve(values_.size());
+      for (const auto& entry : values_)
+        {
+          keys.push_back(entry.first);
+          values.push_back(entry.second);
+        }
+      return FrozenMemoizer<Key,T,Compare>(std::move(keys),std::move(values),values_.key_comp());
+    }
+
+  ////////////////////////////////
+  // snapshot I/O
+  ////////////////////////////////
+
+  template<typename Key, typename T, typename Compare, typename Alloc>
+    void Memoizer<Key,T,Compare,Alloc>::SaveSnapshot(const std::string& filename) const
+    {
+      static_assert(std::is_trivially_copyable_v<Key>, "snapshot requires trivially copyable Key");
+      static_assert(std::is_trivially_copyable_v<T>, "snapshot requires trivially copyable T");
+      static_assert(alignof(Key)<=impl::MemoizerSnapshotHeader::kAlignment);
+      static_assert(alignof(T)<=impl::MemoizerSnapshotHeader::kAlignment);
+      typedef impl::MemoizerSnapshotHeader header_type;
+
+      std::ofstream os(filename,std::ios_base::out|std::ios_base::binary);
+      StreamCheck(bool(os),filename,"Failed to open memoizer snapshot file for output");
+
+      // header
+      header_type header{};
+      std::memcpy(header.magic,header_type::kMagic,sizeof(header.magic));
+      header.version = header_type::kVersion;
+      header.alignment = header_type::kAlignment;
+      header.fingerprint = impl::MemoizerSnapshotFingerprint<Key,T>();
+      header.key_size = sizeof(Key);
+      header.value_size = sizeof(T);
+      header.count = values_.size();
+      WriteBinary<header_type>(os,header);
+
+      // keys and values (gathered into contiguous arrays, in key order)
+      std::vector<Key> keys;
+      std::vector<T> values;
+      keys.reserve(values_.size());
+      values.reserve(values_.size());
+      for (const value_type& entry : values_)
+        {
+          keys.push_back(entry.first);
+          values.push_back(entry.second);
+        }
+      const char padding[header_type::kAlignment] = {};
+      const std::uint64_t key_bytes = keys.size()*sizeof(Key);
+      const std::uint64_t value_bytes = values.size()*sizeof(T);
+      WriteBinary<Key>(os,keys.data(),keys.size());
+      WriteBinary<char>(os,padding,impl::SnapshotPaddedSize(key_bytes)-key_bytes);
+      WriteBinary<T>(os,values.data(),values.size());
+      WriteBinary<char>(os,padding,impl::SnapshotPaddedSize(value_bytes)-value_bytes);
+
+      StreamCheck(bool(os),filename,"Failure while writing memoizer snapshot file");
+    }
+
+  template<typename Key, typename T, typename Compare, typename Alloc>
+    bool Memoizer<Key,T,Compare,Alloc>::LoadSnapshot(const std::string& filename)
+    {
+      static_assert(std::is_trivially_copyable_v<Key>, "snapshot requires trivially copyable Key");
+      static_assert(std::is_trivially_copyable_v<T>, "snapshot requires trivially copyable T");
+
+      MappedFile file(filename);
+      if (!file.is_open())
+        return false;
+      std::uint64_t count;
+      const char* key_ptr;
+      const char* value_ptr;
+      if (!impl::FindMemoizerSnapshotSections<Key,T>(file,filename,count,key_ptr,value_ptr))
+        return false;
+
+      // append entries
+      //   entries are in key order, so end() is the correct insertion
+      //   hint if the memoizer was empty
+      for (std::uint64_t i=0; i<count; ++i)
+        {
+          typename std::aligned_storage<sizeof(Key),alignof(Key)>::type key_storage;
+          typename std::aligned_storage<sizeof(T),alignof(T)>::type value_storage;
+          std::memcpy(&key_storage,key_ptr+i*sizeof(Key),sizeof(Key));
+          std::memcpy(&value_storage,value_ptr+i*sizeof(T),sizeof(T));
+          values_.emplace_hint(
+              values_.end(),
+              *reinterpret_cast<const Key*>(&key_storage),
+              *reinterpret_cast<const T*>(&value_storage)
+            );
+        }
+      statistics_.Resize(values_.size(),values_.size()*kBytesPerEntry);
+
+      return true;
+    }
+
+  template<typename Key, typename T, typename Compare>
+    bool LoadFrozenSnapshot(const std::string& filename, FrozenMemoizer<Key,T,Compare>& table)
+    // Replace contents of table with entries from Memoizer binary
+    // snapshot file.
+    //
+    // The key and value sections of the snapshot are already the sorted
+    // arrays which FrozenMemoizer stores, so they are copied directly,
+    // with one allocation per array, and no per-entry insertion.  The
+    // snapshot must have been saved by a Memoizer with the same
+    // ordering Compare.
+    //
+    // Returns false, leaving the table unchanged, if the file does not
+    // exist, or (with a warning) if it is not a snapshot for this
+    // version and key/value type.
+    {
+      static_assert(std::is_trivially_copyable_v<Key>, "snapshot requires trivially copyable Key");
+      static_assert(std::is_trivially_copyable_v<T>, "snapshot requires trivially copyable T");
+
+      MappedFile file(filename);
+      if (!file.is_open())
+        return false;
+      std::uint64_t count;
+      const char* key_ptr;
+      const char* value_ptr;
+      if (!impl::FindMemoizerSnapshotSections<Key,T>(file,filename,count,key_ptr,value_ptr))
+        return false;
+
+      std::vector<Key> keys(count);
+      std::vector<T> values(count);
+      std::memcpy(static_cast<void*>(keys.data()),key_ptr,count*sizeof(Key));
+      std::memcpy(static_cast<void*>(values.data()),value_ptr,count*sizeof(T));
+      table = FrozenMemoizer<Key,T,Compare>(std::move(keys),std::move(values));
+
+      return true;
+    }
 
   ////////////////////////////////
   // stream output
@@ -269,6 +975,541 @@ namespace mcutils
     return os;
   }
 
+  // fast text output (see io.h)
+  //   uses same delimiters as output operator
+  template<typename Key, typename T, typename Compare, typename Alloc>
+    struct TextFormatter<Memoizer<Key,T,Compare,Alloc>>
+    {
+      typedef Memoizer<Key,T,Compare,Alloc> memoizer_type;
+
+      // append single entry
+      static void AppendEntry(std::string& buffer, const typename memoizer_type::value_type& entry)
+      {
+        buffer += memoizer_type::delimiter_left_;
+        AppendText(buffer,entry.first);
+        buffer += memoizer_type::delimiter_middle_;
+        AppendText(buffer,entry.second);
+        buffer += memoizer_type::delimiter_right_;
+      }
+
+      // append all entries
+      static void Append(std::string& buffer, const memoizer_type& m)
+      {
+        for (const auto& entry : m)
+          AppendEntry(buffer,entry);
+      }
+    };
+
+  // bulk text output
+  //   entries are formatted into a buffer, which is written to the
+  //   stream in blocks
+  template<typename Key, typename T, typename Compare, typename Alloc>
+    void WriteText(std::ostream& os, const Memoizer<Key,T,Compare,Alloc>& m)
+  {
+    TextWriter writer(os);
+    for (const auto& entry : m)
+      {
+        TextFormatter<Memoizer<Key,T,Compare,Alloc>>::AppendEntry(writer.buffer(),entry);
+        writer.Commit();
+      }
+  }
+
+
+
+  ////////////////////////////////////////////////////////////////
+  // HashMemoizer
+  ////////////////////////////////////////////////////////////////
+
+  // HashMemoizer provides the same Seek/GetValue/SetValue interface
+  // as Memoizer (and so may be used with the MEMOIZE macro), but stores
+  // its entries in an open-addressing (linear probing) hash table rather
+  // than a std::map.  Entries live in a single contiguous slot array,
+  // so there is no per-entry allocation, and a lookup costs one hash
+  // evaluation plus a short run of adjacent probes, rather than
+  // O(log n) dependent node loads.
+  //
+  // Any key type with a std::hash specialization may be used out of
+  // the box (e.g., integers, std::string, or mcutils::bit_tuple).
+  //
+  // Caveats:
+  //   - Iteration (and thus stream output) is in hash-table order,
+  //     not in key order.
+  //   - As for std::unordered_map, insertion may rehash the table,
+  //     which invalidates iterators.
+
+  template<typename Key, typename T,
+    typename Hash = std::hash<Key>,
+    typename KeyEqual = std::equal_to<Key> >
+    class HashMemoizer{
+
+    public:
+
+    ////////////////////////////////
+    // type definitions
+    ////////////////////////////////
+
+    // standard map type definitions (subset)
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<const Key, T> value_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+    typedef const value_type& const_reference;
+    typedef const value_type* const_pointer;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    // vector type for key-value pair dump
+    typedef typename std::vector<value_type> vector_type;
+
+    private:
+
+    // hash table slot -- empty or holding a key-value pair
+    typedef std::optional<value_type> slot_type;
+    typedef std::vector<slot_type> slot_vector_type;
+
+    public:
+
+    // forward iterator over occupied slots (read access only)
+    class const_iterator
+    {
+      public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef typename HashMemoizer::value_type value_type;
+      typedef typename HashMemoizer::difference_type difference_type;
+      typedef typename HashMemoizer::const_pointer pointer;
+      typedef typename HashMemoizer::const_reference reference;
+
+      const_iterator() = default;
+      const_iterator(
+          typename slot_vector_type::const_iterator it,
+          typename slot_vector_type::const_iterator end
+        )
+        : it_(it), end_(end)
+      {
+        SkipEmpty();
+      };
+
+      reference operator*() const {return **it_;};
+      pointer operator->() const {return &(**it_);};
+      const_iterator& operator++() {++it_; SkipEmpty(); return *this;};
+      const_iterator operator++(int) {const_iterator tmp(*this); ++(*this); return tmp;};
+      friend bool operator==(const const_iterator& a, const const_iterator& b) {return a.it_==b.it_;};
+      friend bool operator!=(const const_iterator& a, const const_iterator& b) {return a.it_!=b.it_;};
+
+      private:
+      void SkipEmpty() {while ((it_!=end_)&&!it_->has_value()) ++it_;};
+      typename slot_vector_type::const_iterator it_, end_;
+    };
+
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    // default
+    //   default-initialize empty table
+    //   enable or disable caching
+    HashMemoizer() : cache_enabled_(true), size_(0) {};
+    HashMemoizer(bool b) : cache_enabled_(b), size_(0) {};
+
+    // copy -- synthesized constructor copies members
+
+    ////////////////////////////////
+    // accessors
+    ////////////////////////////////
+
+    // Seek(x) seeks entry for key x, returns true if found
+    //   as side effect, saves "y" value for subsequent rapid
+    //   access by GetValue()
+    bool Seek(const Key& x);
+
+    // GetValue() returns the "y" value for
+    //   the most recently sought key
+    //   note: this requires that no recursive call be made
+    //   before GetValue() invoked
+    T GetValue() const;
+
+    // SetValue(y) stores y value
+    //   and returns a copy of this value
+    T SetValue(const Key& x, const T& y);
+
+    // GetOrEmplace(x,f) returns reference to the "y" value for key x,
+    //   first storing f() as this value if x is not yet known
+    //
+    //   Only a single probe sequence is run, unless f() itself modifies
+    //   the table (by recursive invocation of the memoizer).  The value
+    //   returned by f() is moved (not copied) into place.
+    //
+    //   If both Hash and KeyEqual are transparent, x may be of any type
+    //   which they accept, so that no temporary Key needs to be
+    //   constructed for a hit.
+    //
+    //   Caution: The returned reference is invalidated by the next
+    //   insertion into the table.
+    //
+    //   If caching is disabled, f() is stored in a scratch value,
+    //   which is overwritten by the next call.
+    template<typename K, typename F>
+      const T& GetOrEmplace(const K& x, F&& f);
+
+    // Known(x) determines whether or not a value for x is already stored
+    //   for debugging and diagnostic use -- not part of MEMOIZE call
+    bool Known(const Key& x) const {return (FindSlot(x) != kNotFound);}
+
+    ////////////////////////////////
+    // iterators
+    ////////////////////////////////
+
+    // iterators for read access only are defined
+    //   note: iteration order is hash-table order
+
+    const_iterator begin() const {return const_iterator(slots_.begin(),slots_.end());};
+    const_iterator end() const {return const_iterator(slots_.end(),slots_.end());};
+
+    ////////////////////////////////
+    // bulk access
+    ////////////////////////////////
+
+    size_type size() const {return size_;};
+    void clear() {slots_.clear(); size_ = 0; statistics_.Resize(0,0);};
+
+    // reserve(n) sizes the table to hold at least n entries without rehashing
+    void reserve(size_type n);
+
+    ////////////////////////////////
+    // statistics
+    ////////////////////////////////
+
+    // statistics (all zero unless MCUTILS_MEMOIZER_STATISTICS defined)
+    const MemoizerStatistics& statistics() const {return statistics_.statistics();};
+
+    // name to identify memoizer in statistics report
+    void SetName(const std::string& name) {statistics_.SetName(name);};
+
+    ////////////////////////////////
+    // ostream output
+    ////////////////////////////////
+
+    // output operator -- friend declaration for access to delimiters
+    template<typename KeyX, typename TX, typename HashX, typename KeyEqualX>
+    friend std::ostream& operator<< (std::ostream&, const HashMemoizer<KeyX, TX, HashX, KeyEqualX>&);
+
+    ////////////////////////////////
+    // configuration
+    ////////////////////////////////
+
+    // mode flags
+    void EnableCaching(bool b) {cache_enabled_ = b;};
+
+    // configuring delimiter strings
+    //   static member function sets delimiters for *all* HashMemoizer
+    //   instances with the given template parameters
+    // EX: HashMemoizer<...>::SetDelimiters(" ( ", " -> ", " )\n");
+    static void SetDelimiters(const std::string&, const std::string&, const std::string&);
+
+    private:
+
+    ////////////////////////////////
+    // hash table internals
+    ////////////////////////////////
+
+    // sentinel for failed slot search
+    static constexpr size_type kNotFound = static_cast<size_type>(-1);
+
+    // maximum load factor, as ratio kMaxLoadNumerator/kMaxLoadDenominator
+    static constexpr size_type kMaxLoadNumerator = 3;
+    static constexpr size_type kMaxLoadDenominator = 4;
+
+    // minimum (nonzero) number of slots
+    static constexpr size_type kMinSlots = 16;
+
+    // HomeSlot(x) returns starting probe position for key x
+    //
+    // The user hash is scrambled by Fibonacci (multiplicative) hashing,
+    // so that weak hashes (e.g., the identity hash which libstdc++ uses
+    // for integers) still spread over the full table.
+    template<typename K>
+      size_type HomeSlot(const K& x) const
+    {
+      const std::uint64_t h = static_cast<std::uint64_t>(hasher_(x))*UINT64_C(0x9E3779B97F4A7C15);
+      return static_cast<size_type>(h >> (64-log2_slots_));
+    }
+
+    // FindSlot(x) returns slot index holding key x, or kNotFound
+    size_type FindSlot(const Key& x) const;
+
+    // ProbeSlot(x) returns slot index holding key x, or else the empty
+    // slot at which x would be inserted (table must be nonempty)
+    template<typename K>
+      size_type ProbeSlot(const K& x) const;
+
+    // ReserveOne() grows table if insertion of one more entry would
+    // exceed maximum load factor
+    void ReserveOne()
+    {
+      if ((size_+1)*kMaxLoadDenominator > slots_.size()*kMaxLoadNumerator)
+        Rehash(std::max(kMinSlots,2*slots_.size()));
+    }
+
+    // Rehash(n) rebuilds table with n slots (n a power of 2)
+    void Rehash(size_type n);
+
+    ////////////////////////////////
+    // configuration data
+    ////////////////////////////////
+
+    // ostream delimiters (static)
+    static std::string delimiter_left_;
+    static std::string delimiter_middle_;
+    static std::string delimiter_right_;
+
+    // mode variables
+    bool cache_enabled_;
+
+    ////////////////////////////////
+    // caching data
+    ////////////////////////////////
+
+    // hash table slots (size zero or a power of 2)
+    slot_vector_type slots_;
+    unsigned int log2_slots_ = 0;
+    size_type size_;
+
+    // modification counter (incremented on any insertion or rehash)
+    size_type generation_ = 0;
+
+    // hash and equality functors
+    hasher hasher_;
+    key_equal key_equal_;
+
+    // current entry access
+    //   pointer to value found by Seek, valid until next insertion
+    const T* current_result_ = nullptr;
+
+    // scratch value for GetOrEmplace with caching disabled
+    std::optional<T> scratch_result_;
+
+    // statistics
+    impl::MemoizerStatisticsRecorder statistics_;
+
+  };
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    inline
+    typename HashMemoizer<Key,T,Hash,KeyEqual>::size_type
+    HashMemoizer<Key,T,Hash,KeyEqual>::FindSlot(const Key& x) const
+    {
+      if (slots_.empty())
+        return kNotFound;
+
+      // linear probe until key or empty slot found
+      //   guaranteed to terminate since load factor is below 1
+      const size_type mask = slots_.size()-1;
+      for (size_type i = HomeSlot(x); ; i = (i+1)&mask)
+        {
+          const slot_type& slot = slots_[i];
+          if (!slot.has_value())
+            return kNotFound;
+          if (key_equal_(slot->first,x))
+            return i;
+        }
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    template<typename K>
+    inline
+    typename HashMemoizer<Key,T,Hash,KeyEqual>::size_type
+    HashMemoizer<Key,T,Hash,KeyEqual>::ProbeSlot(const K& x) const
+    {
+      const size_type mask = slots_.size()-1;
+      size_type i = HomeSlot(x);
+      while (slots_[i].has_value() && !key_equal_(slots_[i]->first,x))
+        i = (i+1)&mask;
+      return i;
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    void HashMemoizer<Key,T,Hash,KeyEqual>::Rehash(size_type n)
+    {
+      ++generation_;
+      slot_vector_type old_slots(n);
+      std::swap(slots_,old_slots);
+      log2_slots_ = 0;
+      while ((size_type(1) << log2_slots_) < n)
+        ++log2_slots_;
+
+      // reinsert entries from old table
+      //   keys are known to be distinct, so only need to find empty slot
+      const size_type mask = slots_.size()-1;
+      for (slot_type& old_slot : old_slots)
+        {
+          if (!old_slot.has_value())
+            continue;
+          size_type i = HomeSlot(old_slot->first);
+          while (slots_[i].has_value())
+            i = (i+1)&mask;
+          slots_[i].emplace(std::move(*old_slot));
+        }
+      statistics_.Resize(size_,slots_.size()*sizeof(slot_type));
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    void HashMemoizer<Key,T,Hash,KeyEqual>::reserve(size_type n)
+    {
+      size_type num_slots = kMinSlots;
+      while (num_slots*kMaxLoadNumerator < n*kMaxLoadDenominator)
+        num_slots *= 2;
+      if (num_slots > slots_.size())
+        Rehash(num_slots);
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    inline
+    bool HashMemoizer<Key,T,Hash,KeyEqual>::Seek(const Key& x)
+    {
+      if (!cache_enabled_)
+        return false;
+
+      size_type i = FindSlot(x);
+      if (i == kNotFound)
+        {
+          // value will be computed before call to SetValue
+          statistics_.Lookup(false);
+          return false;
+        }
+
+      // store pointer to associated "y" value for rapid access
+      current_result_ = &(slots_[i]->second);
+      statistics_.Lookup(true);
+      return true;
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    inline
+    T HashMemoizer<Key,T,Hash,KeyEqual>::GetValue() const
+    {
+      // return "y" value
+      return *current_result_;
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    inline
+    T HashMemoizer<Key,T,Hash,KeyEqual>::SetValue(const Key& x, const T& y)
+    {
+      if (!cache_enabled_)
+        return y;
+
+      // probe for key or first empty slot
+      //   existing entry is retained, as for std::map::insert, and
+      //   table is only grown (and reprobed) if x must be inserted
+      size_type i = slots_.empty() ? kNotFound : ProbeSlot(x);
+      if ((i == kNotFound) || !slots_[i].has_value())
+        {
+          const size_type generation = generation_;
+          ReserveOne();
+          if ((i == kNotFound) || (generation_ != generation))
+            i = ProbeSlot(x);
+          slots_[i].emplace(x,y);
+          ++size_;
+          ++generation_;
+          statistics_.Insert(size_,slots_.size()*sizeof(slot_type));
+        }
+
+      return y;
+    }
+
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    template<typename K, typename F>
+    inline
+    const T& HashMemoizer<Key,T,Hash,KeyEqual>::GetOrEmplace(const K& x, F&& f)
+    {
+      // without transparent functors, convert to Key once up front,
+      // rather than implicitly at every probe
+      if constexpr (
+          !std::is_same_v<K,Key>
+          && !(is_transparent_v<Hash> && is_transparent_v<KeyEqual>)
+        )
+        return GetOrEmplace(Key(x),std::forward<F>(f));
+      else
+        {
+          if (!cache_enabled_)
+            {
+              scratch_result_.emplace(std::forward<F>(f)());
+              return *scratch_result_;
+            }
+
+          // probe for key or insertion slot
+          //   a hit must not grow the table, which would invalidate
+          //   references returned by earlier calls
+          size_type i = slots_.empty() ? kNotFound : ProbeSlot(x);
+          const bool hit = (i != kNotFound) && slots_[i].has_value();
+          statistics_.Lookup(hit);
+          if (hit)
+            return slots_[i]->second;
+
+          // evaluate value, then grow table for insertion, and reprobe
+          // only if table was modified (by f() or by growth)
+          const size_type generation = generation_;
+          T y = [&]()
+            {
+              impl::MemoizerStatisticsRecorder::ComputeGuard compute_guard(statistics_);
+              return T(std::forward<F>(f)());
+            }();
+          ReserveOne();
+          if ((i == kNotFound) || (generation_ != generation))
+            {
+              i = ProbeSlot(x);
+              if (slots_[i].has_value())
+                return slots_[i]->second;
+            }
+          slots_[i].emplace(std::piecewise_construct,std::forward_as_tuple(x),std::forward_as_tuple(std::move(y)));
+          ++size_;
+          ++generation_;
+          statistics_.Insert(size_,slots_.size()*sizeof(slot_type));
+          return slots_[i]->second;
+        }
+    }
+
+  // initialize delimiter variables
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    std::string HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_left_("  ");
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    std::string HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_middle_("->");
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    std::string HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_right_("\n");
+
+  // delimiter configuration
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    void HashMemoizer<Key,T,Hash,KeyEqual>::SetDelimiters(
+	const std::string& left,
+	const std::string& middle,
+	const std::string& right
+      )
+    {
+      HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_left_ = left;
+      HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_middle_ = middle;
+      HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_right_ = right;
+    };
+
+  // output operator
+  template<typename Key, typename T, typename Hash, typename KeyEqual>
+    std::ostream& operator<< (std::ostream& os, const HashMemoizer<Key,T,Hash,KeyEqual>& m)
+  {
+    for(
+        typename HashMemoizer<Key,T,Hash,KeyEqual>::const_iterator i = m.begin();
+        i != m.end();
+        ++i
+      )
+      {
+        os << HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_left_;
+        os << i->first;
+        os << HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_middle_;
+        os << i->second;
+        os << HashMemoizer<Key,T,Hash,KeyEqual>::delimiter_right_;
+      }
+
+    return os;
+  }
 
 }  // namespace
 
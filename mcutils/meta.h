@@ -7,6 +7,7 @@
   Argonne National Laboratory
 
   02/21/24 (pjf): Created.
+  10/17/26: Add is_transparent.
 
 ****************************************************************/
 
@@ -16,6 +17,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mcutils
@@ -82,6 +85,21 @@ struct is_derived_constructible
 template<typename T, typename... Args>
 constexpr bool is_derived_constructible_v = is_derived_constructible<T, Args...>::value;
 
+
+////////////////////////////////////////////////////////////////
+// is_transparent -- detect if comparator, hasher, or equality
+// predicate declares is_transparent (and so accepts
+// heterogeneous lookup keys)
+////////////////////////////////////////////////////////////////
+template<typename T, typename = void>
+struct is_transparent : std::false_type {};
+
+template<typename T>
+struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+template<typename T>
+constexpr bool is_transparent_v = is_transparent<T>::value;
+
 }  // namespace mcutils
 
 #endif // MCUTILS_META_H_
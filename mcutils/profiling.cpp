@@ -0,0 +1,153 @@
+/****************************************************************
+  profiling.cpp
+
+  Mark A. Caprio
+  University of Notre Dame
+
+  - 10/17/26: Created, with PerfCounterGroup system call interface.
+  - 10/17/26: Report events which were never scheduled as unavailable.
+
+****************************************************************/
+
+#include "profiling.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mcutils
+{
+  ////////////////////////////////////////////////////////////////
+  // hardware performance counters
+  ////////////////////////////////////////////////////////////////
+
+#if defined(__linux__)
+  namespace
+  {
+    int OpenPerfEvent(PerfCounterGroup::Event event, int group_fd)
+    // Open counter for event, for calling thread on any CPU, as leader
+    // of a new group (group_fd=-1) or as member of an existing group.
+    //
+    // Returns file descriptor, or -1 if unavailable.
+    {
+      perf_event_attr attributes;
+      std::memset(&attributes,0,sizeof(attributes));
+      attributes.size = sizeof(attributes);
+      // members follow the leader's enabled state
+      attributes.disabled = (group_fd<0) ? 1 : 0;
+      attributes.exclude_kernel = 1;
+      attributes.exclude_hv = 1;
+      attributes.read_format =
+        PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      attributes.type = PERF_TYPE_HARDWARE;
+      switch (event)
+        {
+        case PerfCounterGroup::kCycles: attributes.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        case PerfCounterGroup::kInstructions: attributes.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case PerfCounterGroup::kCacheReferences: attributes.config = PERF_COUNT_HW_CACHE_REFERENCES; break;
+        case PerfCounterGroup::kCacheMisses: attributes.config = PERF_COUNT_HW_CACHE_MISSES; break;
+        case PerfCounterGroup::kBranchInstructions: attributes.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS; break;
+        case PerfCounterGroup::kBranchMisses: attributes.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case PerfCounterGroup::kLLCReadMisses:
+          attributes.type = PERF_TYPE_HW_CACHE;
+          attributes.config = PERF_COUNT_HW_CACHE_LL
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+          break;
+        default: return -1;
+        }
+      const long fd = syscall(SYS_perf_event_open,&attributes,0,-1,group_fd,0);
+      return (fd<0) ? -1 : int(fd);
+    }
+  }  // namespace
+#endif
+
+  PerfCounterGroup::PerfCounterGroup()
+  {
+    file_descriptors_.fill(-1);
+    leader_descriptors_.fill(-1);
+    group_positions_.fill(0);
+#if defined(__linux__)
+    int leader = -1;
+    int group_size = 0;
+    for (int event=0; event<kNumEvents; ++event)
+      {
+        // join main group, or else open as group of its own
+        int fd = (leader>=0) ? OpenPerfEvent(Event(event),leader) : -1;
+        if (fd>=0)
+          {
+            leader_descriptors_[event] = leader;
+            group_positions_[event] = group_size++;
+          }
+        else
+          {
+            fd = OpenPerfEvent(Event(event),-1);
+            if (fd<0)
+              continue;
+            leader_descriptors_[event] = fd;
+            group_positions_[event] = 0;
+            if (leader<0)
+              {
+                leader = fd;
+                group_size = 1;
+              }
+          }
+        file_descriptors_[event] = fd;
+      }
+#endif
+  }
+
+  PerfCounterGroup::~PerfCounterGroup()
+  {
+#if defined(__linux__)
+    // close members before leaders
+    for (int event=kNumEvents; event-->0;)
+      if (file_descriptors_[event]>=0)
+        close(file_descriptors_[event]);
+#endif
+  }
+
+  double PerfCounterGroup::Count(Event event) const
+  {
+#if defined(__linux__)
+    if (file_descriptors_[event]<0)
+      return std::nan("");
+
+    // group read format: number of events, time enabled, time running,
+    // then one value per event in the group
+    std::uint64_t values[3+kNumEvents];
+    const ssize_t bytes = read(leader_descriptors_[event],values,sizeof(values));
+    const int position = group_positions_[event];
+    if ((bytes<ssize_t(3*sizeof(std::uint64_t))) || (std::uint64_t(position)>=values[0]))
+      return std::nan("");
+    // never scheduled onto the hardware (e.g., starved by multiplexing),
+    // so there is no count to scale, rather than a count of zero
+    if (values[2]==0)
+      return std::nan("");
+    return double(values[3+position])*(double(values[1])/double(values[2]));
+#else
+    return std::nan("");
+#endif
+  }
+
+  void PerfCounterGroup::Control(ControlOperation operation)
+  {
+#if defined(__linux__)
+    const unsigned long request =
+      (operation==kEnable) ? PERF_EVENT_IOC_ENABLE
+      : (operation==kDisable) ? PERF_EVENT_IOC_DISABLE
+      : PERF_EVENT_IOC_RESET;
+    for (int event=0; event<kNumEvents; ++event)
+      if ((file_descriptors_[event]>=0) && (file_descriptors_[event]==leader_descriptors_[event]))
+        ioctl(file_descriptors_[event],request,PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+}  // namespace mcutils
@@ -2,7 +2,8 @@
 
   profiling.h
 
-  Simple walltime stopwatch.
+  Simple walltime stopwatches, scoped profiling regions, and hardware
+  performance counters.
 
   Mark A. Caprio
   University of Notre Dame
@@ -14,6 +15,14 @@
     + Allow accumulation of intervals.
     + Provide accessor for raw clocks.
   - 12/23/17 (mac): Add SteadyTimer based on C++11 chrono library.
+  - 10/17/26: Add ScopedTimer and per-thread profiling call tree, with
+    text and JSON reports.
+  - 10/17/26: Add CycleTimer based on hardware cycle counter.
+  - 10/17/26: Add PerfCounterGroup based on Linux perf_event_open.
+  - 10/17/26: Make ScopedTimer lock free except on region creation, and
+    register exit report only once (thread safe).
+  - 10/17/26: Open PerfCounterGroup events as a single perf event group,
+    and move system call interface to profiling.cpp.
 
                                   
 ****************************************************************/
@@ -21,9 +30,33 @@
 #ifndef PROFILING_H_
 #define PROFILING_H_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <ctime>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
 
 #include "deprecated.h"
 
@@ -182,9 +215,706 @@ namespace mcutils
 
   };
 
+  ////////////////////////////////////////////////////////////////
+  // cycle counter timer
+  ////////////////////////////////////////////////////////////////
+
+  // MCUTILS_HAS_CYCLE_COUNTER is 1 if CycleTimer reads a hardware
+  // counter (the time stamp counter on x86, the virtual counter on
+  // ARM64), or 0 if it falls back to steady_clock.
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+#define MCUTILS_HAS_CYCLE_COUNTER 1
+#else
+#define MCUTILS_HAS_CYCLE_COUNTER 0
+#endif
+
+  inline std::uint64_t ReadCycleCounter()
+  // Read raw tick count of hardware counter.
+  //
+  // On x86, this is the time stamp counter (rdtsc), which on all
+  // current processors ticks at a constant rate, independent of
+  // frequency scaling ("invariant TSC").  The read is not serializing,
+  // so it adds only a few nanoseconds, but it may be reordered with
+  // respect to neighboring instructions, which is negligible except for
+  // regions of a few tens of cycles.
+  //
+  // On ARM64, this is the virtual counter (cntvct_el0).
+  //
+  // Otherwise, this falls back on steady_clock ticks.
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+  }
+
+  inline double CycleCounterFrequency()
+  // Ticks per second of ReadCycleCounter.
+  //
+  // On x86, the frequency is calibrated against steady_clock, once per
+  // program, on first call (taking about 20 ms).  On ARM64, it is read
+  // from the counter frequency register.
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    static const double frequency = []()
+      {
+        const auto steady_start = std::chrono::steady_clock::now();
+        const std::uint64_t ticks_start = ReadCycleCounter();
+        auto steady_end = steady_start;
+        while (steady_end-steady_start < std::chrono::milliseconds(20))
+          steady_end = std::chrono::steady_clock::now();
+        const std::uint64_t ticks_end = ReadCycleCounter();
+        const std::chrono::duration<double> interval = steady_end-steady_start;
+        return (ticks_end-ticks_start)/interval.count();
+      }();
+    return frequency;
+#elif defined(__aarch64__)
+    std::uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return static_cast<double>(frequency);
+#else
+    return static_cast<double>(std::chrono::steady_clock::period::den)/std::chrono::steady_clock::period::num;
+#endif
+  }
+
+  class CycleTimer
+  // Timer using hardware cycle counter.
+  //
+  // Has the same stopwatch interface as SteadyTimer, but is meant for
+  // timing short regions which are entered many times (e.g., inside
+  // inner loops).  Start and Stop each read the cycle counter (see
+  // ReadCycleCounter), which costs a few nanoseconds, rather than
+  // calling steady_clock::now(), and elapsed time is accumulated as an
+  // integer count of ticks.  Ticks are converted to seconds only when
+  // the elapsed time is read.
+  //
+  // The counter is per core, so intervals are only meaningful if the
+  // thread is not migrated between cores with unsynchronized counters
+  // (which is rare on current hardware).
+  {
+
+    public:
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    // default constructor
+    CycleTimer() : accumulated_ticks_(0), start_ticks_(0), timer_is_running_(false)
+      {};
+
+    ////////////////////////////////
+    // stopwatch
+    ////////////////////////////////
+
+    void Start()
+    // Start/resume stopwatch.
+    {
+      assert(!timer_is_running_);
+      timer_is_running_ = true;
+      start_ticks_ = ReadCycleCounter();
+    };
+
+    void Reset()
+    // Reset stopwatch to initial state.
+    {
+      timer_is_running_ = false;
+      accumulated_ticks_ = 0;
+    };
+
+    void Stop()
+    // Stop stopwatch and accumulate ticks since last start.
+    {
+      assert(timer_is_running_);
+      accumulated_ticks_ += ReadCycleCounter()-start_ticks_;
+      timer_is_running_ = false;
+    };
+
+    std::uint64_t ElapsedTicks() const
+    // Elapsed ticks on stopwatch, including any since last start/resume.
+    {
+      std::uint64_t elapsed_ticks = accumulated_ticks_;
+      if (timer_is_running_)
+        elapsed_ticks += ReadCycleCounter()-start_ticks_;
+      return elapsed_ticks;
+    };
+
+    double ElapsedTime() const
+    // Elapsed time on stopwatch, in seconds.
+    {
+      return ElapsedTicks()/CycleCounterFrequency();
+    };
+
+    ////////////////////////////////
+    // timing data
+    ////////////////////////////////
+
+    private:
+
+    std::uint64_t accumulated_ticks_;
+    std::uint64_t start_ticks_;
+    bool timer_is_running_;
+
+  };
+
+  ////////////////////////////////////////////////////////////////
+  // hardware performance counters
+  ////////////////////////////////////////////////////////////////
+
+  class PerfCounterGroup
+  // Hardware performance counters for a region, with wall time.
+  //
+  // Has the same stopwatch interface as SteadyTimer, but also counts
+  // cycles, instructions, cache references and misses, branches and
+  // branch mispredictions, and last-level cache read misses, for the
+  // calling thread (in user mode only), from which the instructions per
+  // cycle, miss rates, and an estimate of memory read bandwidth (one
+  // cache line per last-level miss) may be derived:
+  //
+  //   mcutils::PerfCounterGroup counters;
+  //   counters.Start();
+  //   Kernel();
+  //   counters.Stop();
+  //   counters.Print(std::cout);
+  //
+  // Counters are opened through the Linux perf_event_open system call,
+  // with no external library (see profiling.cpp).  The events are
+  // opened as a single perf event group, led by the first event which
+  // can be opened, so that they are scheduled onto the hardware
+  // together, and the counts (and so derived ratios, such as IPC) cover
+  // exactly the same intervals.  The group is enabled, disabled, and
+  // read (PERF_FORMAT_GROUP) through the leader, in one system call
+  // each.
+  //
+  // An event which the hardware, kernel, or permissions (e.g., with
+  // /proc/sys/kernel/perf_event_paranoid at most 2) do not allow is
+  // left out, and the others are still counted.  An event which cannot
+  // be added to the group (e.g., if the hardware has too few counters
+  // for all the events at once) is instead opened as a group of its
+  // own, which the kernel multiplexes with the main group, and its
+  // count is scaled by the fraction of time it was active.  If no
+  // counters can be opened (or on other operating systems), only wall
+  // time is measured.
+  //
+  // Counts and derived rates for unavailable events, including events
+  // which were never scheduled onto the hardware while counting, are
+  // NaN.
+  {
+
+    public:
+
+    enum Event
+      {
+        kCycles, kInstructions, kCacheReferences, kCacheMisses,
+        kBranchInstructions, kBranchMisses, kLLCReadMisses,
+        kNumEvents
+      };
+
+    static const char* EventName(Event event)
+    {
+      static const char* const names[kNumEvents] =
+        {
+          "cycles", "instructions", "cache-references", "cache-misses",
+          "branches", "branch-misses", "LLC-read-misses"
+        };
+      return names[event];
+    };
+
+    // cache line size assumed for bandwidth estimate
+    static constexpr double kCacheLineBytes = 64;
+
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    PerfCounterGroup();
+    // Open counters (disabled).
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    ~PerfCounterGroup();
+    // Close counters.
+
+    ////////////////////////////////
+    // stopwatch
+    ////////////////////////////////
+
+    void Start()
+    // Start/resume counting.
+    {
+      timer_.Start();
+      Control(kEnable);
+    };
+
+    void Reset()
+    // Stop counting and reset counts to zero.
+    {
+      Control(kDisable);
+      Control(kReset);
+      timer_.Reset();
+    };
+
+    void Stop()
+    // Stop counting, retaining counts.
+    {
+      Control(kDisable);
+      timer_.Stop();
+    };
+
+    ////////////////////////////////
+    // results
+    ////////////////////////////////
+
+    bool Available() const
+    // Whether any hardware counter is available.
+    {
+      return std::any_of(
+          file_descriptors_.begin(),file_descriptors_.end(),
+          [](int fd){return fd>=0;}
+        );
+    };
+
+    bool Available(Event event) const
+    // Whether counter for event is available.
+    {
+      return file_descriptors_[event]>=0;
+    };
+
+    double Count(Event event) const;
+    // Count for event (scaled for multiplexing), or NaN if unavailable.
+
+    double ElapsedTime() const
+    // Elapsed wall time, in seconds.
+    {
+      return timer_.ElapsedTime();
+    };
+
+    double IPC() const
+    // Instructions per cycle.
+    {
+      return Count(kInstructions)/Count(kCycles);
+    };
+
+    double CacheMissRate() const
+    // Fraction of cache references which miss.
+    {
+      return Count(kCacheMisses)/Count(kCacheReferences);
+    };
+
+    double BranchMissRate() const
+    // Fraction of branches which are mispredicted.
+    {
+      return Count(kBranchMisses)/Count(kBranchInstructions);
+    };
+
+    double MemoryBandwidth() const
+    // Estimated memory read bandwidth, in bytes per second.
+    {
+      return Count(kLLCReadMisses)*kCacheLineBytes/ElapsedTime();
+    };
+
+    void Print(std::ostream& os) const
+    // Print counts and derived rates.
+    {
+      os << "time " << ElapsedTime() << " s";
+      if (!Available())
+        {
+          os << " (hardware counters unavailable)" << std::endl;
+          return;
+        }
+      os << std::endl;
+      for (int event=0; event<kNumEvents; ++event)
+        {
+          os << "  " << std::left << std::setw(20) << EventName(Event(event)) << std::right;
+          if (Available(Event(event)))
+            os << std::setw(16) << std::fixed << std::setprecision(0) << Count(Event(event)) << std::defaultfloat;
+          else
+            os << std::setw(16) << "n/a";
+          os << std::endl;
+        }
+      auto rate = [](double value)
+        {
+          std::ostringstream text;
+          text << std::setprecision(3) << value;
+          return std::isnan(value) ? std::string("n/a") : text.str();
+        };
+      os << "  IPC " << rate(IPC())
+         << ", cache miss rate " << rate(CacheMissRate())
+         << ", branch miss rate " << rate(BranchMissRate())
+         << ", memory read bandwidth " << rate(MemoryBandwidth()/1e9) << " GB/s"
+         << std::endl;
+    };
+
+    private:
+
+    enum ControlOperation {kEnable, kDisable, kReset};
+
+    void Control(ControlOperation operation);
+    // Apply operation to all groups of counters.
+
+    // for each event: its own file descriptor (or -1 if unavailable),
+    // the file descriptor of its group leader, and its position in the
+    // values read from the group
+    std::array<int,kNumEvents> file_descriptors_;
+    std::array<int,kNumEvents> leader_descriptors_;
+    std::array<int,kNumEvents> group_positions_;
+    SteadyTimer timer_;
+  };
+
+  ////////////////////////////////////////////////////////////////
+  // scoped profiling regions
+  ////////////////////////////////////////////////////////////////
+
+  // A ScopedTimer times the enclosing scope, from construction to
+  // destruction, and records the interval in a global profile.  Regions
+  // nested inside other regions (in the same thread) are recorded as
+  // children, so that the profile is a call tree, with, for each
+  // region, the number of calls, the inclusive time (the whole region)
+  // and exclusive time (less time in child regions), and the minimum
+  // and maximum time per call.  Each thread has its own call tree.
+  //
+  // Instrumentation is normally placed through the macro
+  // MCUTILS_PROFILE_SCOPE, which declares a ScopedTimer only if
+  // MCUTILS_PROFILING is defined (e.g., by configuring with
+  // -DMCUTILS_PROFILING=ON), and otherwise expands to nothing, so that
+  // it may be left in production code:
+  //
+  //   mcutils::ReportProfileAtExit("profile.json");
+  //   ...
+  //   void Iterate()
+  //   {
+  //     MCUTILS_PROFILE_SCOPE("Iterate");
+  //     ...
+  //   }
+  //
+  // Times are in seconds, represented as type double.
+  //
+  // Entering and leaving an existing region takes no lock.  Each call
+  // tree is only modified by its own thread: the statistics are atomic
+  // (updated with relaxed loads and stores, since there is a single
+  // writer), so that they may be read by a report at any time, and the
+  // thread's mutex is only taken to add a region to the tree, and by
+  // reports, to walk the tree.  A report taken while regions are
+  // active is a snapshot, in which the statistics of a region may not
+  // all reflect the same call.
+
+  struct ProfileRegion
+  // Statistics for one node of the profiling call tree.
+  {
+    typedef std::chrono::steady_clock::duration duration;
+
+    std::string name;
+    std::size_t parent = npos;  // index of parent region (npos for root)
+    std::vector<std::size_t> children;  // indices of child regions
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<duration> inclusive_time{duration(0)};
+    std::atomic<duration> child_time{duration(0)};
+    std::atomic<duration> min_time{duration::max()};
+    std::atomic<duration> max_time{duration(0)};
+
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    double InclusiveTime() const {return ToSeconds(Load(inclusive_time));};
+    double ExclusiveTime() const {return ToSeconds(Load(inclusive_time)-Load(child_time));};
+    double MinTime() const {return (Load(count)==0) ? 0. : ToSeconds(Load(min_time));};
+    double MaxTime() const {return ToSeconds(Load(max_time));};
+
+    template<typename X>
+      static X Load(const std::atomic<X>& x) {return x.load(std::memory_order_relaxed);};
+
+    static double ToSeconds(std::chrono::steady_clock::duration duration)
+    {
+      return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+    };
+  };
+
+  struct ThreadProfile
+  // Profiling call tree for one thread.
+  //
+  // Region 0 is the root, representing the thread itself.  Regions are
+  // held in a deque, so that adding a region does not move the others.
+  {
+    int thread_index;
+    std::deque<ProfileRegion> regions;
+    std::size_t current_region = 0;  // innermost active region (owning thread only)
+    std::mutex mutex;  // guards addition of regions against concurrent reporting
+  };
+
+  void PrintProfile(std::ostream& os);
+  // Print indented call tree of all regions, for each thread.
+
+  void WriteProfileJSON(std::ostream& os);
+  // Write call trees for all threads as JSON.
+
+  void ReportProfileAtExit(const std::string& json_filename = "");
+  // Register PrintProfile(std::cout) to run at program exit, and, if a
+  // filename is given, also WriteProfileJSON to that file.
+
+  namespace impl
+  {
+    struct ProfileRegistry
+    {
+      std::mutex mutex;
+      std::vector<std::shared_ptr<ThreadProfile>> threads;
+      std::string json_filename;
+    };
+
+    inline ProfileRegistry& GetProfileRegistry()
+    // Access global registry.
+    //
+    // The registry is intentionally never destroyed, so that it is
+    // still available to exit-time reporting.
+    {
+      static ProfileRegistry* registry = new ProfileRegistry;
+      return *registry;
+    }
+
+    inline ThreadProfile& GetThreadProfile()
+    // Access call tree for calling thread, registering it on first use.
+    {
+      thread_local std::shared_ptr<ThreadProfile> profile = []()
+        {
+          auto profile = std::make_shared<ThreadProfile>();
+          profile->regions.emplace_back();
+          profile->regions.back().name = "(thread)";
+          ProfileRegistry& registry = GetProfileRegistry();
+          std::lock_guard<std::mutex> lock(registry.mutex);
+          profile->thread_index = int(registry.threads.size());
+          registry.threads.push_back(profile);
+          return profile;
+        }();
+      return *profile;
+    }
+
+    inline std::string EscapeJSON(const std::string& text)
+    // Escape string for use as JSON string literal.
+    {
+      std::string escaped;
+      for (char c : text)
+        {
+          if ((c=='"') || (c=='\\'))
+            {
+              escaped += '\\';
+              escaped += c;
+            }
+          else if (static_cast<unsigned char>(c)<0x20)
+            {
+              char code[8];
+              std::snprintf(code,sizeof(code),"\\u%04x",static_cast<unsigned>(c));
+              escaped += code;
+            }
+          else
+            escaped += c;
+        }
+      return escaped;
+    }
+
+    inline void PrintProfileRegion(std::ostream& os, const ThreadProfile& profile, std::size_t index, int depth)
+    {
+      const ProfileRegion& region = profile.regions[index];
+      os << std::left << std::setw(40) << (std::string(2*depth,' ')+region.name) << std::right
+         << std::setw(12) << region.count
+         << std::fixed << std::setprecision(6)
+         << std::setw(14) << region.InclusiveTime()
+         << std::setw(14) << region.ExclusiveTime()
+         << std::setw(14) << region.MinTime()
+         << std::setw(14) << region.MaxTime()
+         << std::defaultfloat
+         << std::endl;
+      for (std::size_t child : region.children)
+        PrintProfileRegion(os,profile,child,depth+1);
+    }
+
+    inline void WriteProfileRegionJSON(std::ostream& os, const ThreadProfile& profile, std::size_t index)
+    {
+      const ProfileRegion& region = profile.regions[index];
+      os << "{\"name\":\"" << EscapeJSON(region.name) << "\""
+         << ",\"calls\":" << region.count
+         << std::scientific << std::setprecision(9)
+         << ",\"inclusive\":" << region.InclusiveTime()
+         << ",\"exclusive\":" << region.ExclusiveTime()
+         << ",\"min\":" << region.MinTime()
+         << ",\"max\":" << region.MaxTime()
+         << std::defaultfloat << std::setprecision(6)
+         << ",\"children\":[";
+      for (std::size_t i=0; i<region.children.size(); ++i)
+        {
+          if (i>0)
+            os << ",";
+          WriteProfileRegionJSON(os,profile,region.children[i]);
+        }
+      os << "]}";
+    }
+  }  // namespace impl
+
+  class ScopedTimer
+  // Timer for profiling region, from construction to destruction.
+  //
+  // The name should be a literal or otherwise identify the region
+  // uniquely among its siblings in the call tree.
+  {
+
+    public:
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    explicit ScopedTimer(const char* name)
+      // Enter region and start timing.
+      : profile_(impl::GetThreadProfile())
+      {
+        parent_ = profile_.current_region;
+
+        // find or create child region
+        //   only this thread modifies the tree, so it may be searched
+        //   without locking
+        region_ = ProfileRegion::npos;
+        for (std::size_t child : profile_.regions[parent_].children)
+          if (profile_.regions[child].name==name)
+            {
+              region_ = child;
+              break;
+            }
+        if (region_==ProfileRegion::npos)
+          {
+            std::lock_guard<std::mutex> lock(profile_.mutex);
+            region_ = profile_.regions.size();
+            profile_.regions.emplace_back();
+            profile_.regions.back().name = name;
+            profile_.regions.back().parent = parent_;
+            profile_.regions[parent_].children.push_back(region_);
+          }
+        profile_.current_region = region_;
+
+        start_time_ = std::chrono::steady_clock::now();
+      };
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer()
+      // Stop timing and leave region.
+      {
+        const ProfileRegion::duration time = std::chrono::steady_clock::now()-start_time_;
+        ProfileRegion& region = profile_.regions[region_];
+        Store(region.count,ProfileRegion::Load(region.count)+1);
+        Store(region.inclusive_time,ProfileRegion::Load(region.inclusive_time)+time);
+        Store(region.min_time,std::min(ProfileRegion::Load(region.min_time),time));
+        Store(region.max_time,std::max(ProfileRegion::Load(region.max_time),time));
+        ProfileRegion& parent = profile_.regions[parent_];
+        Store(parent.child_time,ProfileRegion::Load(parent.child_time)+time);
+        profile_.current_region = parent_;
+      };
+
+    private:
+
+    // update by owning thread (the only writer)
+    template<typename X>
+      static void Store(std::atomic<X>& x, X value) {x.store(value,std::memory_order_relaxed);};
+
+    ThreadProfile& profile_;
+    std::size_t parent_, region_;
+    std::chrono::steady_clock::time_point start_time_;
+  };
+
+  inline void PrintProfile(std::ostream& os)
+  {
+    impl::ProfileRegistry& registry = impl::GetProfileRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    os << "Profile" << std::endl;
+    os << std::left << std::setw(40) << "region" << std::right
+       << std::setw(12) << "calls"
+       << std::setw(14) << "inclusive(s)"
+       << std::setw(14) << "exclusive(s)"
+       << std::setw(14) << "min(s)"
+       << std::setw(14) << "max(s)"
+       << std::endl;
+    for (const auto& profile : registry.threads)
+      {
+        std::lock_guard<std::mutex> thread_lock(profile->mutex);
+        os << "thread " << profile->thread_index << std::endl;
+        for (std::size_t child : profile->regions[0].children)
+          impl::PrintProfileRegion(os,*profile,child,1);
+      }
+  }
+
+  inline void WriteProfileJSON(std::ostream& os)
+  {
+    impl::ProfileRegistry& registry = impl::GetProfileRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    os << "{\"threads\":[";
+    for (std::size_t t=0; t<registry.threads.size(); ++t)
+      {
+        const ThreadProfile& profile = *registry.threads[t];
+        std::lock_guard<std::mutex> thread_lock(registry.threads[t]->mutex);
+        if (t>0)
+          os << ",";
+        os << "{\"thread\":" << profile.thread_index << ",\"regions\":[";
+        const std::vector<std::size_t>& roots = profile.regions[0].children;
+        for (std::size_t i=0; i<roots.size(); ++i)
+          {
+            if (i>0)
+              os << ",";
+            impl::WriteProfileRegionJSON(os,profile,roots[i]);
+          }
+        os << "]}";
+      }
+    os << "]}" << std::endl;
+  }
+
+  inline void ReportProfileAtExit(const std::string& json_filename)
+  {
+    static std::once_flag registered;
+    {
+      impl::ProfileRegistry& registry = impl::GetProfileRegistry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.json_filename = json_filename;
+    }
+    std::call_once(
+        registered,
+        []()
+        {
+          std::atexit(
+              []()
+              {
+                PrintProfile(std::cout);
+                std::string filename;
+                {
+                  impl::ProfileRegistry& registry = impl::GetProfileRegistry();
+                  std::lock_guard<std::mutex> lock(registry.mutex);
+                  filename = registry.json_filename;
+                }
+                if (!filename.empty())
+                  {
+                    std::ofstream json_stream(filename);
+                    WriteProfileJSON(json_stream);
+                  }
+              }
+            );
+        }
+      );
+  }
 
 }  // namespace
 
+// scoped profiling macro
+//   expands to nothing unless MCUTILS_PROFILING is defined
+#define MCUTILS_PROFILE_CONCAT_IMPL(a,b) a##b
+#define MCUTILS_PROFILE_CONCAT(a,b) MCUTILS_PROFILE_CONCAT_IMPL(a,b)
+#ifdef MCUTILS_PROFILING
+#define MCUTILS_PROFILE_SCOPE(name) \
+  mcutils::ScopedTimer MCUTILS_PROFILE_CONCAT(mcutils_scoped_timer_,__LINE__)(name)
+#else
+#define MCUTILS_PROFILE_SCOPE(name) do {} while (0)
+#endif
+
 // legacy support for global definitions
 
 #ifdef MCUTILS_ALLOW_LEGACY_GLOBAL
@@ -3,13 +3,40 @@
   vector_tuple.h
 
   Template library for fixed-length tuples of arithmetic types, 
-  based on storage in a vector.  Supported arithmetic operations:
+  based on inline array storage.  Supported arithmetic operations:
     -- unary + -
     -- entrywise + - * /
-    -- lexicographical comparison
+    -- multiplication and division by scalar
+    -- entrywise fused multiply-add
+    -- reductions: Sum, Dot, Norm, Min, Max
+    -- lexicographical comparison (three-way Compare)
+    -- hashing (std::hash specialization)
+    -- packing of bounded integer tuples into 64-bit keys
+
+  Arithmetic is by expression templates: an arithmetic expression
+  such as a+b*c-d (or 2*a) yields a lightweight expression object,
+  which is only evaluated when assigned to (or used to construct) a
+  VectorTuple, in a single loop over the entries, with no intermediate
+  tuples.  The entrywise operations are inlined into this loop (there
+  are no calls through function pointers), so that, for arithmetic T,
+  the compiler can unroll and vectorize it.  Reductions likewise
+  accept expressions, e.g., Dot(a-b,a-b) is a single loop.
+
+  Note: An expression object refers to its VectorTuple operands, and
+  should not outlive them.  So do not store expressions in "auto"
+  variables -- declare the result as a VectorTuple instead, or
+  evaluate the expression explicitly with Eval():
+
+    auto e = a+b;          // expression referring to a and b
+    VectorTuple<...> c = a+b;  // evaluated tuple
+    auto d = (a+b).Eval();     // evaluated tuple
+
+  This is a change from earlier versions, in which the operators
+  returned a VectorTuple, so that "auto c = a+b;" was a tuple.  Such
+  code must now use one of the latter forms.
 
   Created by Mark A. Caprio 11/27/10
-  Inspired by Tomas Dytrych CTuple.h, but using vector rather than array.
+  Inspired by Tomas Dytrych CTuple.h.
                                   
   - 12/15/10 (mac):
     + add option template parameter B=0 as indexing base for VectorTuple.
@@ -22,6 +49,20 @@
   - 2/23/11 (mac):
     + fix namespace issues
   - 6/9/17 (mac): Move into namespace mcutils.
+  - 10/17/26: Store entries in std::array rather than std::vector, so
+    that construction, copying, and arithmetic do not allocate, and
+    make operations constexpr.
+  - 10/17/26: Evaluate arithmetic by expression templates, and add
+    multiplication and division by scalar.
+  - 10/17/26: Add reductions and entrywise fused multiply-add.
+  - 10/17/26: Add three-way comparison Compare (and operator<=> under
+    C++20), and base ordering operators on it.
+  - 10/17/26: Add std::hash specialization, VectorTuplePacker, and
+    conversion to and from bit_tuple.
+  - 10/17/26: Add TextFormatter specialization for fast text output.
+  - 10/17/26: Guard full-width shifts in VectorTuplePacker and
+    FromBitTuple.
+  - 10/17/26: Add Eval() for explicit evaluation of expressions.
                                   
 ****************************************************************/
 
@@ -29,19 +70,60 @@
 #ifndef MCUTILS_VECTOR_TUPLE_H_
 #define MCUTILS_VECTOR_TUPLE_H_
 
+#include <climits>
 #include <cstddef>
+#include <cstdint>
 #include <algorithm>
+#include <cmath>
+#include <array>
+#if __cplusplus >= 202002L
+#include <compare>
+#endif
+#include <functional>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "arithmetic.h"
+#include "io.h"
+
 namespace mcutils
 {
+
+  template<class T, size_t N, size_t B> class VectorTuple;
+
+  ////////////////////////////////////////////////////////////////
+  // expression base
+  ////////////////////////////////////////////////////////////////
+
+  template<class T, size_t N, size_t B, class E>
+    class VectorTupleExpression
+    // Base for VectorTuple and for arithmetic expressions yielding a
+    // VectorTuple<T,N,B>.
+    //
+    // The derived class E must provide Evaluate(i), which returns entry
+    // i (0-based, irrespective of B) of the result.
+    {
+      public:
+
+      // downcast to derived expression
+      constexpr const E& expression() const {return static_cast<const E&>(*this);};
+
+      // Eval() returns the evaluated tuple, e.g., for storage in an
+      //   "auto" variable
+      constexpr VectorTuple<T,N,B> Eval() const {return VectorTuple<T,N,B>(expression());};
+    };
+
   ////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////
 
   template<class T, size_t N, size_t B=0>
-    class VectorTuple{
+    class VectorTuple
+    : public VectorTupleExpression<T,N,B,VectorTuple<T,N,B>>
+    {
 
     public:
 
@@ -49,14 +131,17 @@ namespace mcutils
     // type definitions
     ////////////////////////////////
 
-    // standard vector definitions (subset)
-    typedef typename std::vector<T>::iterator iterator;
-    typedef typename std::vector<T>::const_iterator const_iterator;
-    typedef typename std::vector<T>::size_type size_type;
-    typedef typename std::vector<T>::difference_type difference_type;
-    typedef typename std::vector<T>::value_type value_type;
-    typedef typename std::vector<T>::reverse_iterator reverse_iterator;
-    typedef typename std::vector<T>::const_reverse_iterator const_reverse_iterator;
+    // underlying storage type
+    typedef typename std::array<T,N> array_type;
+
+    // standard container definitions (subset)
+    typedef typename array_type::iterator iterator;
+    typedef typename array_type::const_iterator const_iterator;
+    typedef typename array_type::size_type size_type;
+    typedef typename array_type::difference_type difference_type;
+    typedef typename array_type::value_type value_type;
+    typedef typename array_type::reverse_iterator reverse_iterator;
+    typedef typename array_type::const_reverse_iterator const_reverse_iterator;
 
     // related vector type
     typedef typename std::vector<T> vector_type;
@@ -65,40 +150,55 @@ namespace mcutils
     // constructors
     ////////////////////////////////
 
-    // default -- default-initialize vector of correct length
-    VectorTuple() : values_(N){};
+    // default -- value-initialize entries
+    constexpr VectorTuple() : values_{} {};
 
     // copy -- synthesized constructor copies value
 
     // initialization by fill with constant value
-    explicit VectorTuple(const T& a) : values_(N,a) {};
+    explicit constexpr VectorTuple(const T& a) : values_{}
+    {
+      for (size_type i=0; i<N; ++i)
+        values_[i] = a;
+    };
 	
     // conversion from vector 
-    VectorTuple(const vector_type& v) : values_(v) {};
+    //   copies the first N entries (any missing entries are value-initialized)
+    VectorTuple(const vector_type& v) : values_{}
+    {
+      std::copy_n(v.begin(),std::min(v.size(),N),values_.begin());
+    };
+
+    // evaluation of arithmetic expression
+    template<class E>
+      constexpr VectorTuple(const VectorTupleExpression<T,N,B,E>& e) : values_{}
+    {
+      Assign(e.expression());
+    };
 
     ////////////////////////////////
     // accessors
     ////////////////////////////////
 
     // entry access by indexing (nonconst and const references)
-    T& operator[](size_type i) {return values_[i-B];};
-    const T& operator[](size_type i) const {return values_[i-B];};
-
-    // copy of entries as a vector
-    // std::vector<T> GetVector() const {return values_;};
+    constexpr T& operator[](size_type i) {return values_[i-B];};
+    constexpr const T& operator[](size_type i) const {return values_[i-B];};
 
     // iterators
-    iterator begin() {return values_.begin();};
-    iterator end() {return values_.end();};
-    const_iterator begin() const {return values_.begin();};
-    const_iterator end() const {return values_.end();};
-    reverse_iterator rbegin() {return values_.rbegin();};
-    reverse_iterator rend() {return values_.rend();};
-    const_reverse_iterator rbegin() const {return values_.rbegin();};
-    const_reverse_iterator rend() const {return values_.rend();};
+    constexpr iterator begin() {return values_.begin();};
+    constexpr iterator end() {return values_.end();};
+    constexpr const_iterator begin() const {return values_.begin();};
+    constexpr const_iterator end() const {return values_.end();};
+    constexpr reverse_iterator rbegin() {return values_.rbegin();};
+    constexpr reverse_iterator rend() {return values_.rend();};
+    constexpr const_reverse_iterator rbegin() const {return values_.rbegin();};
+    constexpr const_reverse_iterator rend() const {return values_.rend();};
 
     // size
-    size_type size() const {return values_.size();};
+    constexpr size_type size() const {return N;};
+
+    // entry access for expression evaluation (0-based)
+    constexpr const T& Evaluate(size_type i) const {return values_[i];};
 
     ////////////////////////////////
     // arithmetic assignment operators
@@ -106,25 +206,36 @@ namespace mcutils
 
     // assignment --  synthesized assignment copies value
 
-    VectorTuple& operator += (const VectorTuple&);
-    VectorTuple& operator -= (const VectorTuple&);
-    VectorTuple& operator *= (const VectorTuple&);
-    VectorTuple& operator /= (const VectorTuple&);
-	
-    ////////////////////////////////
-    // unary arithmetic operators
-    ////////////////////////////////
+    // assignment from arithmetic expression
+    //   Each entry of the expression depends only on the same entry of
+    //   its operands, so the target may also appear in the expression.
+    template<class E>
+      constexpr VectorTuple& operator = (const VectorTupleExpression<T,N,B,E>& e)
+    {
+      Assign(e.expression());
+      return *this;
+    };
 
-    VectorTuple operator + () const;
-    VectorTuple operator - () const;
+    template<class E> constexpr VectorTuple& operator += (const VectorTupleExpression<T,N,B,E>&);
+    template<class E> constexpr VectorTuple& operator -= (const VectorTupleExpression<T,N,B,E>&);
+    template<class E> constexpr VectorTuple& operator *= (const VectorTupleExpression<T,N,B,E>&);
+    template<class E> constexpr VectorTuple& operator /= (const VectorTupleExpression<T,N,B,E>&);
 
+    // scaling by scalar
+    constexpr VectorTuple& operator *= (const T&);
+    constexpr VectorTuple& operator /= (const T&);
+	
     ////////////////////////////////
     // ostream output
     ////////////////////////////////
 
     // output operator -- friend declaration for access to delimiters
-    template <class TX, size_t NX, size_t BX>
-    friend std::ostream& operator<< (std::ostream&, const VectorTuple<TX,NX,BX>&);
+    template <class TX, size_t NX, size_t BX, class EX>
+    friend std::ostream& operator<< (std::ostream&, const VectorTupleExpression<TX,NX,BX,EX>&);
+
+    // fast text output -- friend declaration for access to delimiters
+    template <typename, typename>
+    friend struct TextFormatter;
 
     // configuring delimiter strings
     //   static member function sets delimiters for *all* VectorTuple 
@@ -134,13 +245,21 @@ namespace mcutils
 
     private:
 
+    // evaluate expression into entries
+    template<class E>
+      constexpr void Assign(const E& e)
+    {
+      for (size_type i=0; i<N; ++i)
+        values_[i] = e.Evaluate(i);
+    };
+
     // ostream delimiters
     static std::string delimiter_left_;
     static std::string delimiter_middle_;
     static std::string delimiter_right_;
 
     // instance data storage
-    vector_type values_;
+    array_type values_;
 
   };
 
@@ -149,6 +268,10 @@ namespace mcutils
   ////////////////////////////////
 
   // note: didn't get <functional> functors to work in this role
+  //
+  // note: these are retained for use with std::transform, but the
+  // VectorTuple operators are written as plain loops (which are
+  // constexpr, and which the compiler can unroll for small N)
 
   template<class T> T BinaryPlus(const T& a, const T& b)
     {
@@ -171,35 +294,173 @@ namespace mcutils
       return -a;
     }
 
+  ////////////////////////////////
+  // expression templates
+  ////////////////////////////////
+
+  namespace impl
+  {
+
+    // entrywise operations
+    struct VectorTuplePlus
+    {
+      template<class X, class Y> static constexpr auto Apply(const X& x, const Y& y) {return x+y;};
+    };
+    struct VectorTupleMinus
+    {
+      template<class X, class Y> static constexpr auto Apply(const X& x, const Y& y) {return x-y;};
+    };
+    struct VectorTupleTimes
+    {
+      template<class X, class Y> static constexpr auto Apply(const X& x, const Y& y) {return x*y;};
+    };
+    struct VectorTupleDivide
+    {
+      template<class X, class Y> static constexpr auto Apply(const X& x, const Y& y) {return x/y;};
+    };
+    struct VectorTupleNegate
+    {
+      template<class X> static constexpr auto Apply(const X& x) {return -x;};
+    };
+    struct VectorTupleFusedMultiplyAdd
+    {
+      // single rounding for floating point types (std::fma), otherwise
+      // ordinary multiply and add
+      template<class X> static constexpr X Apply(const X& x, const X& y, const X& z)
+      {
+        if constexpr (std::is_floating_point_v<X>)
+          return std::fma(x,y,z);
+        else
+          return x*y+z;
+      };
+    };
+
+    // operand storage in expression
+    //
+    // VectorTuple operands are held by reference, and expression
+    // operands (which are small temporaries) by value.
+    template<class E>
+      struct VectorTupleOperand
+      {
+        typedef E type;
+      };
+    template<class T, size_t N, size_t B>
+      struct VectorTupleOperand<VectorTuple<T,N,B>>
+      {
+        typedef const VectorTuple<T,N,B>& type;
+      };
+
+    // scalar argument type (excluded from template argument deduction,
+    // so that, e.g., a VectorTuple<double,N> may be multiplied by an int)
+    template<class T>
+      struct VectorTupleScalar
+      {
+        typedef T type;
+      };
+
+    template<class T, size_t N, size_t B, class Op, class E1, class E2>
+      class VectorTupleBinaryExpression
+      : public VectorTupleExpression<T,N,B,VectorTupleBinaryExpression<T,N,B,Op,E1,E2>>
+      {
+        public:
+        constexpr VectorTupleBinaryExpression(const E1& a, const E2& b) : a_(a), b_(b) {};
+        constexpr T Evaluate(size_t i) const {return Op::Apply(a_.Evaluate(i),b_.Evaluate(i));};
+        private:
+        typename VectorTupleOperand<E1>::type a_;
+        typename VectorTupleOperand<E2>::type b_;
+      };
+
+    template<class T, size_t N, size_t B, class Op, class E>
+      class VectorTupleUnaryExpression
+      : public VectorTupleExpression<T,N,B,VectorTupleUnaryExpression<T,N,B,Op,E>>
+      {
+        public:
+        explicit constexpr VectorTupleUnaryExpression(const E& a) : a_(a) {};
+        constexpr T Evaluate(size_t i) const {return Op::Apply(a_.Evaluate(i));};
+        private:
+        typename VectorTupleOperand<E>::type a_;
+      };
+
+    template<class T, size_t N, size_t B, class Op, class E1, class E2, class E3>
+      class VectorTupleTernaryExpression
+      : public VectorTupleExpression<T,N,B,VectorTupleTernaryExpression<T,N,B,Op,E1,E2,E3>>
+      {
+        public:
+        constexpr VectorTupleTernaryExpression(const E1& a, const E2& b, const E3& c) : a_(a), b_(b), c_(c) {};
+        constexpr T Evaluate(size_t i) const {return Op::Apply(T(a_.Evaluate(i)),T(b_.Evaluate(i)),T(c_.Evaluate(i)));};
+        private:
+        typename VectorTupleOperand<E1>::type a_;
+        typename VectorTupleOperand<E2>::type b_;
+        typename VectorTupleOperand<E3>::type c_;
+      };
+
+    // scalar broadcast to all entries
+    template<class T, size_t N, size_t B>
+      class VectorTupleScalarExpression
+      : public VectorTupleExpression<T,N,B,VectorTupleScalarExpression<T,N,B>>
+      {
+        public:
+        explicit constexpr VectorTupleScalarExpression(const T& a) : a_(a) {};
+        constexpr const T& Evaluate(size_t) const {return a_;};
+        private:
+        T a_;
+      };
+
+  }  // namespace impl
+
   ////////////////////////////////
   // arithmetic assignment operators
   ////////////////////////////////
 
   template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator += (const VectorTuple& b)
+    template <class E>
+    constexpr VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator += (const VectorTupleExpression<T,N,B,E>& b)
     {
-      std::transform(values_.begin(),values_.end(),b.values_.begin(),values_.begin(),BinaryPlus<T>);
+      for (size_type i=0; i<N; ++i)
+        values_[i] += b.expression().Evaluate(i);
       return *this;
     }
 
   template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator -= (const VectorTuple& b)
+    template <class E>
+    constexpr VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator -= (const VectorTupleExpression<T,N,B,E>& b)
     {
-      std::transform(values_.begin(),values_.end(),b.values_.begin(),values_.begin(),BinaryMinus<T>);
+      for (size_type i=0; i<N; ++i)
+        values_[i] -= b.expression().Evaluate(i);
       return *this;
     }
 
   template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator *= (const VectorTuple& b)
+    template <class E>
+    constexpr VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator *= (const VectorTupleExpression<T,N,B,E>& b)
     {
-      std::transform(values_.begin(),values_.end(),b.values_.begin(),values_.begin(),BinaryTimes<T>);
+      for (size_type i=0; i<N; ++i)
+        values_[i] *= b.expression().Evaluate(i);
       return *this;
     }
 
   template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator /= (const VectorTuple& b)
+    template <class E>
+    constexpr VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator /= (const VectorTupleExpression<T,N,B,E>& b)
     {
-      std::transform(values_.begin(),values_.end(),b.values_.begin(),values_.begin(),BinaryDivide<T>);
+      for (size_type i=0; i<N; ++i)
+        values_[i] /= b.expression().Evaluate(i);
+      return *this;
+    }
+
+  template <class T, size_t N, size_t B>
+    constexpr VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator *= (const T& a)
+    {
+      for (size_type i=0; i<N; ++i)
+        values_[i] *= a;
+      return *this;
+    }
+
+  template <class T, size_t N, size_t B>
+    constexpr VectorTuple<T,N,B>& VectorTuple<T,N,B>::operator /= (const T& a)
+    {
+      for (size_type i=0; i<N; ++i)
+        values_[i] /= a;
       return *this;
     }
 
@@ -207,18 +468,17 @@ namespace mcutils
   // unary arithmetic operators
   ////////////////////////////////
 
-  template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B> VectorTuple<T,N,B>::operator + () const 
+  template <class T, size_t N, size_t B, class E>
+    constexpr const E& operator + (const VectorTupleExpression<T,N,B,E>& a)
     {
-      return *this;
+      return a.expression();
     };
 
-  template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B> VectorTuple<T,N,B>::operator - () const 
+  template <class T, size_t N, size_t B, class E>
+    constexpr impl::VectorTupleUnaryExpression<T,N,B,impl::VectorTupleNegate,E>
+    operator - (const VectorTupleExpression<T,N,B,E>& a)
     {
-      VectorTuple<T,N,B> c;
-      std::transform(values_.begin(),values_.end(),c.values_.begin(),UnaryMinus<T>);
-      return c;
+      return impl::VectorTupleUnaryExpression<T,N,B,impl::VectorTupleNegate,E>(a.expression());
     };
 
 
@@ -226,74 +486,235 @@ namespace mcutils
   // binary arithmetic operators
   ////////////////////////////////
 
-  template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B> operator + (const VectorTuple<T,N,B>& a, const VectorTuple<T,N,B>& b) 
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTuplePlus,E1,E2>
+    operator + (const VectorTupleExpression<T,N,B,E1>& a, const VectorTupleExpression<T,N,B,E2>& b)
     {
-      VectorTuple<T,N,B> c(a);
-      c += b;
-      return c;
+      return impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTuplePlus,E1,E2>(a.expression(),b.expression());
     }
 
-  template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B> operator - (const VectorTuple<T,N,B>& a, const VectorTuple<T,N,B>& b) 
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleMinus,E1,E2>
+    operator - (const VectorTupleExpression<T,N,B,E1>& a, const VectorTupleExpression<T,N,B,E2>& b)
     {
-      VectorTuple<T,N,B> c(a);
-      c -=b;
-      return c;
+      return impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleMinus,E1,E2>(a.expression(),b.expression());
     }
 
-  template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B> operator * (const VectorTuple<T,N,B>& a, const VectorTuple<T,N,B>& b) 
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleTimes,E1,E2>
+    operator * (const VectorTupleExpression<T,N,B,E1>& a, const VectorTupleExpression<T,N,B,E2>& b)
     {
-      VectorTuple<T,N,B> c(a);
-      c *= b;
-      return c;
+      return impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleTimes,E1,E2>(a.expression(),b.expression());
     }
 
-  template <class T, size_t N, size_t B>
-    VectorTuple<T,N,B> operator / (const VectorTuple<T,N,B>& a, const VectorTuple<T,N,B>& b) 
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleDivide,E1,E2>
+    operator / (const VectorTupleExpression<T,N,B,E1>& a, const VectorTupleExpression<T,N,B,E2>& b)
+    {
+      return impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleDivide,E1,E2>(a.expression(),b.expression());
+    }
+
+  ////////////////////////////////
+  // scalar arithmetic operators
+  ////////////////////////////////
+
+  template <class T, size_t N, size_t B, class E>
+    constexpr impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleTimes,E,impl::VectorTupleScalarExpression<T,N,B>>
+    operator * (const VectorTupleExpression<T,N,B,E>& a, const typename impl::VectorTupleScalar<T>::type& s)
+    {
+      return impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleTimes,E,impl::VectorTupleScalarExpression<T,N,B>>(
+          a.expression(),impl::VectorTupleScalarExpression<T,N,B>(s)
+        );
+    }
+
+  template <class T, size_t N, size_t B, class E>
+    constexpr impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleTimes,impl::VectorTupleScalarExpression<T,N,B>,E>
+    operator * (const typename impl::VectorTupleScalar<T>::type& s, const VectorTupleExpression<T,N,B,E>& a)
     {
-      VectorTuple<T,N,B> c(a);
-      c /= b;
-      return c;
+      return impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleTimes,impl::VectorTupleScalarExpression<T,N,B>,E>(
+          impl::VectorTupleScalarExpression<T,N,B>(s),a.expression()
+        );
+    }
+
+  template <class T, size_t N, size_t B, class E>
+    constexpr impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleDivide,E,impl::VectorTupleScalarExpression<T,N,B>>
+    operator / (const VectorTupleExpression<T,N,B,E>& a, const typename impl::VectorTupleScalar<T>::type& s)
+    {
+      return impl::VectorTupleBinaryExpression<T,N,B,impl::VectorTupleDivide,E,impl::VectorTupleScalarExpression<T,N,B>>(
+          a.expression(),impl::VectorTupleScalarExpression<T,N,B>(s)
+        );
+    }
+
+  ////////////////////////////////
+  // fused multiply-add
+  ////////////////////////////////
+
+  // FusedMultiplyAdd(a,b,c) is the entrywise a*b+c, evaluated with a
+  // single rounding (via std::fma) for floating point entries
+  template <class T, size_t N, size_t B, class E1, class E2, class E3>
+    constexpr impl::VectorTupleTernaryExpression<T,N,B,impl::VectorTupleFusedMultiplyAdd,E1,E2,E3>
+    FusedMultiplyAdd(
+        const VectorTupleExpression<T,N,B,E1>& a,
+        const VectorTupleExpression<T,N,B,E2>& b,
+        const VectorTupleExpression<T,N,B,E3>& c
+      )
+    {
+      return impl::VectorTupleTernaryExpression<T,N,B,impl::VectorTupleFusedMultiplyAdd,E1,E2,E3>(
+          a.expression(),b.expression(),c.expression()
+        );
+    }
+
+  ////////////////////////////////
+  // reductions
+  ////////////////////////////////
+
+  // Sum(a) returns sum of entries
+  template <class T, size_t N, size_t B, class E>
+    constexpr T Sum(const VectorTupleExpression<T,N,B,E>& a)
+    {
+      T sum{};
+      for (size_t i=0; i<N; ++i)
+        sum += a.expression().Evaluate(i);
+      return sum;
+    }
+
+  // Dot(a,b) returns sum of products of entries
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr T Dot(const VectorTupleExpression<T,N,B,E1>& a, const VectorTupleExpression<T,N,B,E2>& b)
+    {
+      T sum{};
+      for (size_t i=0; i<N; ++i)
+        sum += a.expression().Evaluate(i)*b.expression().Evaluate(i);
+      return sum;
+    }
+
+  // Norm(a) returns Euclidean norm sqrt(Dot(a,a))
+  //   result is floating point (double for integral T)
+  template <class T, size_t N, size_t B, class E>
+    auto Norm(const VectorTupleExpression<T,N,B,E>& a)
+    {
+      return std::sqrt(Dot(a,a));
+    }
+
+  // Min(a) and Max(a) return least and greatest entry
+  template <class T, size_t N, size_t B, class E>
+    constexpr T Min(const VectorTupleExpression<T,N,B,E>& a)
+    {
+      static_assert(N>0, "Min requires nonempty tuple");
+      T result = a.expression().Evaluate(0);
+      for (size_t i=1; i<N; ++i)
+        {
+          const T& entry = a.expression().Evaluate(i);
+          result = (entry<result) ? entry : result;
+        }
+      return result;
+    }
+
+  template <class T, size_t N, size_t B, class E>
+    constexpr T Max(const VectorTupleExpression<T,N,B,E>& a)
+    {
+      static_assert(N>0, "Max requires nonempty tuple");
+      T result = a.expression().Evaluate(0);
+      for (size_t i=1; i<N; ++i)
+        {
+          const T& entry = a.expression().Evaluate(i);
+          result = (result<entry) ? entry : result;
+        }
+      return result;
     }
 
   ////////////////////////////////
   // relational operators
   ////////////////////////////////
 
-  template <class T, size_t N, size_t B>
-    bool operator == (const VectorTuple<T,N,B>& v1, const VectorTuple<T,N,B>& v2)
+  // note: These accept arithmetic expressions as well as tuples.
+  //
+  // The ordering operators are all based on the three-way comparison
+  // Compare, so each makes a single pass over the entries.  Equality
+  // needs only a single pass over the entries in any case, and is
+  // tested directly.
+
+  // Compare(v1,v2) returns -1, 0, or +1 as v1 is lexicographically
+  //   less than, equal to, or greater than v2
+  //
+  //   For short tuples of integers, the comparison is made without
+  //   branching: all entries are compared, and the first nonzero
+  //   entrywise result is kept by masking.  This avoids mispredicted
+  //   early exits when, e.g., sorting tuples which often share leading
+  //   entries.
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr int Compare(const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
   {
-    return equal(v1.begin(),v1.end(),v2.begin());
+    if constexpr (std::is_integral_v<T> && (N<=4))
+      {
+        int result = 0;
+        for (size_t i=0; i<N; ++i)
+          {
+            const T a = v1.expression().Evaluate(i);
+            const T b = v2.expression().Evaluate(i);
+            const int entry_result = int(a>b)-int(a<b);
+            result |= entry_result & -int(result==0);
+          }
+        return result;
+      }
+    else
+      {
+        for (size_t i=0; i<N; ++i)
+          {
+            const T& a = v1.expression().Evaluate(i);
+            const T& b = v2.expression().Evaluate(i);
+            if (a<b)
+              return -1;
+            if (b<a)
+              return +1;
+          }
+        return 0;
+      }
   }
 
-  template <class T, size_t N, size_t B>
-    bool operator < (const VectorTuple<T,N,B>& v1, const VectorTuple<T,N,B>& v2)
+#if __cplusplus >= 202002L
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr std::strong_ordering operator <=> (const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
   {
-    return lexicographical_compare(v1.begin(),v1.end(),v2.begin(),v2.end());
+    return Compare(v1,v2) <=> 0;
   }
+#endif
 
-  template <class T, size_t N, size_t B>
-    bool operator > (const VectorTuple<T,N,B>& v1, const VectorTuple<T,N,B>& v2)
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr bool operator == (const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
   {
-    return !((v1==v2)||(v1<v2));
+    for (size_t i=0; i<N; ++i)
+      if (!(v1.expression().Evaluate(i)==v2.expression().Evaluate(i)))
+        return false;
+    return true;
   }
 
-  template <class T, size_t N, size_t B>
-    bool operator >= (const VectorTuple<T,N,B>& v1, const VectorTuple<T,N,B>& v2)
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr bool operator < (const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
   {
-    return !(v1 < v2);
+    return Compare(v1,v2) < 0;
   }
 
-  template <class T, size_t N, size_t B>
-    bool operator <= (const VectorTuple<T,N,B>& v1, const VectorTuple<T,N,B>& v2)
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr bool operator > (const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
   {
-    return ((v1 < v2)||(v1 == v2));
+    return Compare(v1,v2) > 0;
   }
 
-  template <class T, size_t N, size_t B>
-    bool operator != (const VectorTuple<T,N,B>& v1, const VectorTuple<T,N,B>& v2)
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr bool operator >= (const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
+  {
+    return Compare(v1,v2) >= 0;
+  }
+
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr bool operator <= (const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
+  {
+    return Compare(v1,v2) <= 0;
+  }
+
+  template <class T, size_t N, size_t B, class E1, class E2>
+    constexpr bool operator != (const VectorTupleExpression<T,N,B,E1>& v1, const VectorTupleExpression<T,N,B,E2>& v2)
   {
     return !(v1 == v2);
   }
@@ -325,24 +746,232 @@ namespace mcutils
 
 
   // output operator
-  template <class T, size_t N, size_t B>
-    std::ostream& operator<< (std::ostream& os, const VectorTuple<T,N,B>& v)
+  //   also accepts arithmetic expression, which is written as the
+  //   resulting tuple
+  template <class T, size_t N, size_t B, class E>
+    std::ostream& operator<< (std::ostream& os, const VectorTupleExpression<T,N,B,E>& v)
   {
     os << VectorTuple<T,N,B>::delimiter_left_;
-    for(typename VectorTuple<T,N,B>::const_iterator i = v.begin(); i != v.end(); ++i)
+    for (size_t i=0; i<N; ++i)
       {
-        if (i != v.begin())
+        if (i != 0)
           os << VectorTuple<T,N,B>::delimiter_middle_;
-        os << (*i);
+        os << v.expression().Evaluate(i);
       }
     os << VectorTuple<T,N,B>::delimiter_right_;
 
     return os;
   }
 
+  // fast text output (see io.h)
+  //   uses same delimiters as output operator
+  template <class T, size_t N, size_t B>
+    struct TextFormatter<VectorTuple<T,N,B>>
+    {
+      static void Append(std::string& buffer, const VectorTuple<T,N,B>& v)
+      {
+        buffer += VectorTuple<T,N,B>::delimiter_left_;
+        for (size_t i=0; i<N; ++i)
+          {
+            if (i != 0)
+              buffer += VectorTuple<T,N,B>::delimiter_middle_;
+            AppendText(buffer,v.Evaluate(i));
+          }
+        buffer += VectorTuple<T,N,B>::delimiter_right_;
+      }
+    };
+
+
+  ////////////////////////////////
+  // packing into integer keys
+  ////////////////////////////////
+
+  template<class T, size_t N, size_t B=0>
+    class VectorTuplePacker
+    // Packing of tuples of bounded integers into a single 64-bit key.
+    //
+    // Each entry x[i], with lower[i]<=x[i]<=upper[i], is offset by its
+    // lower bound and stored in a bit field just wide enough for its
+    // range.  The first entry occupies the most significant bits (as
+    // for bit_tuple), so that keys are ordered as the tuples are.
+    // Packed keys give O(1) hashing and equality, e.g., as keys for
+    // HashMemoizer or DenseMemoizer.
+    //
+    // Ex:
+    //   mcutils::VectorTuplePacker<int,3> packer(lower,upper);
+    //   std::uint64_t key = packer.Pack(x);
+    //   mcutils::VectorTuple<int,3> y = packer.Unpack(key);
+    {
+      static_assert(std::is_integral_v<T>, "VectorTuplePacker requires integral entries");
+
+      public:
+
+      typedef VectorTuple<T,N,B> tuple_type;
+      typedef std::uint64_t key_type;
+
+      // construct packer for tuples with lower<=x<=upper
+      //   throws std::length_error if ranges require more than 64 bits
+      VectorTuplePacker(const tuple_type& lower, const tuple_type& upper)
+        : lower_(lower), upper_(upper)
+      {
+        unsigned int offset = 0;
+        for (size_t i=N; i-->0;)
+          {
+            const key_type range = key_type(upper_.Evaluate(i))-key_type(lower_.Evaluate(i));
+            unsigned int width = 0;
+            while ((width<64) && (range>>width))
+              ++width;
+            offsets_[i] = offset;
+            offset += width;
+          }
+        if (offset>64)
+          throw std::length_error("VectorTuplePacker: tuple range requires more than 64 bits");
+        bits_ = offset;
+      };
+
+      // total number of bits used in key
+      unsigned int bits() const {return bits_;};
+
+      // InRange(x) determines whether x lies within packing bounds
+      template<class E>
+        constexpr bool InRange(const VectorTupleExpression<T,N,B,E>& x) const
+      {
+        bool in_range = true;
+        for (size_t i=0; i<N; ++i)
+          {
+            const T entry = x.expression().Evaluate(i);
+            in_range &= (lower_.Evaluate(i)<=entry) && (entry<=upper_.Evaluate(i));
+          }
+        return in_range;
+      };
+
+      // Pack(x) returns key for x (which must lie within bounds)
+      template<class E>
+        constexpr key_type Pack(const VectorTupleExpression<T,N,B,E>& x) const
+      {
+        // an entry with zero width may lie at offset 64, past the end of
+        //   the key, where shifting would be undefined
+        key_type key = 0;
+        for (size_t i=0; i<N; ++i)
+          if (offsets_[i]<64)
+            key |= (key_type(x.expression().Evaluate(i))-key_type(lower_.Evaluate(i))) << offsets_[i];
+        return key;
+      };
+
+      // Unpack(key) returns tuple for key
+      constexpr tuple_type Unpack(key_type key) const
+      {
+        tuple_type x;
+        for (size_t i=0; i<N; ++i)
+          {
+            const unsigned int width = ((i==0) ? bits_ : offsets_[i-1])-offsets_[i];
+            const key_type mask = (width==64) ? ~key_type(0) : ((key_type(1)<<width)-1);
+            const key_type field = (offsets_[i]<64) ? ((key>>offsets_[i])&mask) : 0;
+            x[i+B] = T(key_type(lower_.Evaluate(i))+field);
+          }
+        return x;
+      };
+
+      private:
+
+      tuple_type lower_, upper_;
+      std::array<unsigned int,N> offsets_;
+      unsigned int bits_;
+    };
+
+  ////////////////////////////////
+  // conversion to and from bit_tuple
+  ////////////////////////////////
+
+  // These accept any bit_tuple (see bit_tuple.h) with N fields, which
+  // are matched to tuple entries in order.  Entries are truncated to
+  // their field widths, so negative entries must be offset by the
+  // caller.
+  //
+  // Ex:
+  //   typedef mcutils::bit_tuple<std::uint32_t,8,8,16> label_type;
+  //   label_type label = mcutils::ToBitTuple<label_type>(x);
+  //   mcutils::VectorTuple<int,3> y = mcutils::FromBitTuple<int,3>(label);
+
+  namespace impl
+  {
+    template<class tBitTuple, class E, size_t... indices>
+      constexpr tBitTuple ToBitTuple(const E& x, std::index_sequence<indices...>)
+      {
+        // convert entries to storage type before shifting into place
+        typedef decltype(std::declval<tBitTuple>().bitrep()) storage_type;
+        return tBitTuple(storage_type(x.Evaluate(indices))...);
+      }
+  }  // namespace impl
+
+  template<class tBitTuple, class T, size_t N, size_t B, class E>
+    constexpr tBitTuple ToBitTuple(const VectorTupleExpression<T,N,B,E>& x)
+    // Pack tuple into bit_tuple of type tBitTuple.
+    {
+      return impl::ToBitTuple<tBitTuple>(x.expression(),std::make_index_sequence<N>());
+    }
+
+  template<
+      class T, size_t N, size_t B=0,
+      template<typename, std::size_t...> class tBitTuple, typename tStorageType, std::size_t... sizes
+    >
+    constexpr VectorTuple<T,N,B> FromBitTuple(const tBitTuple<tStorageType,sizes...>& t)
+    // Unpack bit_tuple into tuple, with one shift and mask per entry.
+    {
+      static_assert(sizeof...(sizes)==N, "bit_tuple must have one field per tuple entry");
+      constexpr std::array<std::size_t,N> field_sizes{sizes...};
+      constexpr std::size_t storage_bits = sizeof(tStorageType)*CHAR_BIT;
+      const tStorageType storage = t.bitrep();
+      VectorTuple<T,N,B> x;
+      std::size_t offset = (sizes + ... + 0);
+      for (size_t i=0; i<N; ++i)
+        {
+          offset -= field_sizes[i];
+          if (field_sizes[i]==0)
+            {
+              x[i+B] = T(0);
+              continue;
+            }
+          const tStorageType max_value = (field_sizes[i]==storage_bits)
+            ? ~tStorageType(0)
+            : (tStorageType(1) << field_sizes[i]) - 1;
+          x[i+B] = T((storage >> offset) & max_value);
+        }
+      return x;
+    }
 
 }  // namespace
 
+namespace std
+{
+  // define overload of std::hash to allow use of VectorTuple with
+  // unordered containers
+  //
+  // The entry hashes are combined through a strong mixing function,
+  // so that tuples of small integers (for which std::hash is typically
+  // the identity) are well distributed.
+  template<class T, size_t N, size_t B>
+    struct hash<mcutils::VectorTuple<T,N,B>>
+    {
+      std::size_t operator()(const mcutils::VectorTuple<T,N,B>& v) const noexcept
+      {
+        std::uint64_t h = N;
+        for (size_t i=0; i<N; ++i)
+          h = mcutils::HashMix(h ^ (std::uint64_t(std::hash<T>()(v.Evaluate(i)))+0x9e3779b97f4a7c15ULL));
+        return std::size_t(h);
+      }
+    };
+}  // namespace std
+
+namespace mcutils
+{
+  template<class T, size_t N, size_t B>
+    std::size_t hash_value(const VectorTuple<T,N,B>& v) noexcept
+    {
+      return std::hash<VectorTuple<T,N,B>>()(v);
+    }
+}  // namespace mcutils
+
 // legacy support for global definitions
 
 #ifdef MCUTILS_ALLOW_LEGACY_GLOBAL
@@ -0,0 +1,437 @@
+/****************************************************************
+
+  vector_tuple_array.h
+
+  Array of VectorTuple values, in structure-of-arrays layout.
+
+  VectorTupleArray<T,N,B> holds a sequence of tuples, which would
+  otherwise be stored as std::vector<VectorTuple<T,N,B>>, as N separate
+  columns, one per tuple entry.  Bulk operations (arithmetic over the
+  whole array, sorting, searching) then run over contiguous columns of
+  scalars, which uses memory bandwidth efficiently and can be
+  vectorized by the compiler.
+
+  Element access a[i] returns a proxy, which may be used wherever a
+  VectorTuple expression is accepted (arithmetic, comparison, output),
+  converts to VectorTuple<T,N,B>, and may be assigned from a VectorTuple
+  (or VectorTuple expression).  Entries of the proxy are indexed with
+  base B, as for VectorTuple:
+
+    mcutils::VectorTupleArray<int,3> a(100);
+    a[0] = mcutils::VectorTuple<int,3>(1);
+    a[1][2] = 5;
+    mcutils::VectorTuple<int,3> x = a[0]+a[1];
+
+  Note: As with VectorTuple expressions, do not store a proxy in an
+  "auto" variable unless a reference into the array is intended.
+
+  - 10/17/26: Created.
+  - 10/17/26: Sort in single pass with lexicographic comparison, and
+    declare proxy copy constructor.
+
+****************************************************************/
+
+#ifndef MCUTILS_VECTOR_TUPLE_ARRAY_H_
+#define MCUTILS_VECTOR_TUPLE_ARRAY_H_
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <vector>
+
+#include "vector_tuple.h"
+
+namespace mcutils
+{
+  ////////////////////////////////////////////////////////////////
+  ////////////////////////////////////////////////////////////////
+
+  template<class T, size_t N, size_t B=0>
+    class VectorTupleArray{
+
+    public:
+
+    ////////////////////////////////
+    // type definitions
+    ////////////////////////////////
+
+    typedef VectorTuple<T,N,B> value_type;
+    typedef std::vector<T> column_type;
+    typedef std::size_t size_type;
+
+    class reference;
+    class const_reference;
+
+    ////////////////////////////////
+    // constructors
+    ////////////////////////////////
+
+    // default -- empty array
+    VectorTupleArray() : size_(0) {};
+
+    // construct array of n value-initialized tuples
+    explicit VectorTupleArray(size_type n) : size_(0) {resize(n);};
+
+    // conversion from vector of tuples
+    explicit VectorTupleArray(const std::vector<value_type>& v);
+
+    ////////////////////////////////
+    // accessors
+    ////////////////////////////////
+
+    // element access (array index is 0-based)
+    reference operator[](size_type i) {return reference(this,i);};
+    const_reference operator[](size_type i) const {return const_reference(this,i);};
+
+    // column of k-th tuple entries (k is indexed with base B)
+    const column_type& column(size_type k) const {return columns_[k-B];};
+    column_type& column(size_type k) {return columns_[k-B];};
+
+    // conversion to vector of tuples
+    std::vector<value_type> ToVector() const;
+
+    ////////////////////////////////
+    // size
+    ////////////////////////////////
+
+    size_type size() const {return size_;};
+    void resize(size_type n);
+    void reserve(size_type n);
+    void clear() {resize(0);};
+
+    // append tuple (or value of tuple expression)
+    template<class E>
+      void push_back(const VectorTupleExpression<T,N,B,E>& x)
+    {
+      for (size_t d=0; d<N; ++d)
+        columns_[d].push_back(x.expression().Evaluate(d));
+      ++size_;
+    };
+
+    ////////////////////////////////
+    // bulk arithmetic
+    ////////////////////////////////
+
+    // entrywise arithmetic with array of same size
+    VectorTupleArray& operator += (const VectorTupleArray&);
+    VectorTupleArray& operator -= (const VectorTupleArray&);
+    VectorTupleArray& operator *= (const VectorTupleArray&);
+    VectorTupleArray& operator /= (const VectorTupleArray&);
+
+    // addition or subtraction of the same tuple to every element
+    template<class E> VectorTupleArray& operator += (const VectorTupleExpression<T,N,B,E>&);
+    template<class E> VectorTupleArray& operator -= (const VectorTupleExpression<T,N,B,E>&);
+
+    // scaling by scalar
+    VectorTupleArray& operator *= (const T&);
+    VectorTupleArray& operator /= (const T&);
+
+    ////////////////////////////////
+    // sorting and searching
+    ////////////////////////////////
+
+    // SortPermutation() returns permutation which sorts the tuples
+    //   into lexicographic order, i.e., the j-th tuple in sorted order
+    //   is the permutation[j]-th tuple in the array
+    //
+    //   This is a single stable sort of the index, comparing tuples
+    //   column by column, and stopping at the first column which
+    //   differs (usually the first).
+    std::vector<size_type> SortPermutation() const;
+
+    // Permute(permutation) reorders tuples, so that the j-th tuple
+    //   becomes the permutation[j]-th tuple of the original array
+    void Permute(const std::vector<size_type>& permutation);
+
+    // Sort() sorts tuples into lexicographic order (stably)
+    void Sort() {Permute(SortPermutation());};
+
+    // Find(x) returns index of tuple equal to x, or size() if none
+    //   requires that array be sorted
+    //
+    //   The range of candidate tuples is narrowed by a binary search on
+    //   each column in turn.
+    template<class E>
+      size_type Find(const VectorTupleExpression<T,N,B,E>& x) const;
+
+    private:
+
+    std::array<column_type,N> columns_;
+    size_type size_;
+
+  };
+
+  ////////////////////////////////
+  // element proxies
+  ////////////////////////////////
+
+  template<class T, size_t N, size_t B>
+    class VectorTupleArray<T,N,B>::const_reference
+    : public VectorTupleExpression<T,N,B,typename VectorTupleArray<T,N,B>::const_reference>
+    {
+      public:
+
+      const_reference(const VectorTupleArray* array, size_type index)
+        : array_(array), index_(index)
+      {};
+
+      // entry access (indexed with base B)
+      const T& operator[](size_type k) const {return array_->columns_[k-B][index_];};
+
+      // entry access for expression evaluation (0-based)
+      const T& Evaluate(size_type k) const {return array_->columns_[k][index_];};
+
+      private:
+
+      const VectorTupleArray* array_;
+      size_type index_;
+    };
+
+  template<class T, size_t N, size_t B>
+    class VectorTupleArray<T,N,B>::reference
+    : public VectorTupleExpression<T,N,B,typename VectorTupleArray<T,N,B>::reference>
+    {
+      public:
+
+      reference(VectorTupleArray* array, size_type index)
+        : array_(array), index_(index)
+      {};
+
+      // copy -- refers to same element
+      reference(const reference&) = default;
+
+      // assignment stores tuple into array
+      //   (tuple entries depend only on the same entries of the operands,
+      //   so the expression may itself refer to this element)
+      template<class E>
+        const reference& operator = (const VectorTupleExpression<T,N,B,E>& x) const
+      {
+        for (size_t d=0; d<N; ++d)
+          array_->columns_[d][index_] = x.expression().Evaluate(d);
+        return *this;
+      };
+      const reference& operator = (const reference& x) const
+      {
+        return operator=(static_cast<const VectorTupleExpression<T,N,B,reference>&>(x));
+      };
+
+      // entry access (indexed with base B)
+      T& operator[](size_type k) const {return array_->columns_[k-B][index_];};
+
+      // entry access for expression evaluation (0-based)
+      const T& Evaluate(size_type k) const {return array_->columns_[k][index_];};
+
+      private:
+
+      VectorTupleArray* array_;
+      size_type index_;
+    };
+
+  ////////////////////////////////
+  // construction and size
+  ////////////////////////////////
+
+  template<class T, size_t N, size_t B>
+    VectorTupleArray<T,N,B>::VectorTupleArray(const std::vector<value_type>& v)
+    : size_(v.size())
+    {
+      for (size_t d=0; d<N; ++d)
+        {
+          columns_[d].resize(size_);
+          for (size_type i=0; i<size_; ++i)
+            columns_[d][i] = v[i].Evaluate(d);
+        }
+    }
+
+  template<class T, size_t N, size_t B>
+    std::vector<typename VectorTupleArray<T,N,B>::value_type> VectorTupleArray<T,N,B>::ToVector() const
+    {
+      std::vector<value_type> v(size_);
+      for (size_type i=0; i<size_; ++i)
+        v[i] = (*this)[i];
+      return v;
+    }
+
+  template<class T, size_t N, size_t B>
+    void VectorTupleArray<T,N,B>::resize(size_type n)
+    {
+      for (auto& column : columns_)
+        column.resize(n);
+      size_ = n;
+    }
+
+  template<class T, size_t N, size_t B>
+    void VectorTupleArray<T,N,B>::reserve(size_type n)
+    {
+      for (auto& column : columns_)
+        column.reserve(n);
+    }
+
+  ////////////////////////////////
+  // bulk arithmetic
+  ////////////////////////////////
+
+  template<class T, size_t N, size_t B>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator += (const VectorTupleArray& b)
+    {
+      assert(b.size_==size_);
+      for (size_t d=0; d<N; ++d)
+        {
+          T* x = columns_[d].data();
+          const T* y = b.columns_[d].data();
+          for (size_type i=0; i<size_; ++i)
+            x[i] += y[i];
+        }
+      return *this;
+    }
+
+  template<class T, size_t N, size_t B>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator -= (const VectorTupleArray& b)
+    {
+      assert(b.size_==size_);
+      for (size_t d=0; d<N; ++d)
+        {
+          T* x = columns_[d].data();
+          const T* y = b.columns_[d].data();
+          for (size_type i=0; i<size_; ++i)
+            x[i] -= y[i];
+        }
+      return *this;
+    }
+
+  template<class T, size_t N, size_t B>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator *= (const VectorTupleArray& b)
+    {
+      assert(b.size_==size_);
+      for (size_t d=0; d<N; ++d)
+        {
+          T* x = columns_[d].data();
+          const T* y = b.columns_[d].data();
+          for (size_type i=0; i<size_; ++i)
+            x[i] *= y[i];
+        }
+      return *this;
+    }
+
+  template<class T, size_t N, size_t B>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator /= (const VectorTupleArray& b)
+    {
+      assert(b.size_==size_);
+      for (size_t d=0; d<N; ++d)
+        {
+          T* x = columns_[d].data();
+          const T* y = b.columns_[d].data();
+          for (size_type i=0; i<size_; ++i)
+            x[i] /= y[i];
+        }
+      return *this;
+    }
+
+  template<class T, size_t N, size_t B>
+    template<class E>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator += (const VectorTupleExpression<T,N,B,E>& b)
+    {
+      for (size_t d=0; d<N; ++d)
+        {
+          T* x = columns_[d].data();
+          const T y = b.expression().Evaluate(d);
+          for (size_type i=0; i<size_; ++i)
+            x[i] += y;
+        }
+      return *this;
+    }
+
+  template<class T, size_t N, size_t B>
+    template<class E>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator -= (const VectorTupleExpression<T,N,B,E>& b)
+    {
+      for (size_t d=0; d<N; ++d)
+        {
+          T* x = columns_[d].data();
+          const T y = b.expression().Evaluate(d);
+          for (size_type i=0; i<size_; ++i)
+            x[i] -= y;
+        }
+      return *this;
+    }
+
+  template<class T, size_t N, size_t B>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator *= (const T& a)
+    {
+      for (auto& column : columns_)
+        for (T& x : column)
+          x *= a;
+      return *this;
+    }
+
+  template<class T, size_t N, size_t B>
+    VectorTupleArray<T,N,B>& VectorTupleArray<T,N,B>::operator /= (const T& a)
+    {
+      for (auto& column : columns_)
+        for (T& x : column)
+          x /= a;
+      return *this;
+    }
+
+  ////////////////////////////////
+  // sorting and searching
+  ////////////////////////////////
+
+  template<class T, size_t N, size_t B>
+    std::vector<typename VectorTupleArray<T,N,B>::size_type> VectorTupleArray<T,N,B>::SortPermutation() const
+    {
+      std::vector<size_type> permutation(size_);
+      std::iota(permutation.begin(),permutation.end(),size_type(0));
+      const auto& columns = columns_;
+      std::stable_sort(
+          permutation.begin(),permutation.end(),
+          [&columns](size_type i, size_type j)
+          {
+            for (size_t d=0; d<N; ++d)
+              {
+                if (columns[d][i]<columns[d][j])
+                  return true;
+                if (columns[d][j]<columns[d][i])
+                  return false;
+              }
+            return false;
+          }
+        );
+      return permutation;
+    }
+
+  template<class T, size_t N, size_t B>
+    void VectorTupleArray<T,N,B>::Permute(const std::vector<size_type>& permutation)
+    {
+      assert(permutation.size()==size_);
+      column_type permuted(size_);
+      for (auto& column : columns_)
+        {
+          for (size_type j=0; j<size_; ++j)
+            permuted[j] = column[permutation[j]];
+          column.swap(permuted);
+        }
+    }
+
+  template<class T, size_t N, size_t B>
+    template<class E>
+    typename VectorTupleArray<T,N,B>::size_type VectorTupleArray<T,N,B>::Find(const VectorTupleExpression<T,N,B,E>& x) const
+    {
+      size_type lower = 0, upper = size_;
+      for (size_t d=0; d<N; ++d)
+        {
+          const T value = x.expression().Evaluate(d);
+          const auto first = columns_[d].begin();
+          lower = std::lower_bound(first+lower,first+upper,value)-first;
+          upper = std::upper_bound(first+lower,first+upper,value)-first;
+          if (lower==upper)
+            return size_;
+        }
+      return lower;
+    }
+
+}  // namespace
+
+#endif
@@ -0,0 +1,128 @@
+/******************************************************************************
+
+  bit_tuple_map_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/bit_tuple_map.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+  typedef mcutils::bit_tuple<std::uint64_t,16,16,16> label_type;
+  bool success = true;
+
+  // labels with mostly-zero high bits
+  std::vector<label_type> labels;
+  for (std::uint64_t n=0; n<40; ++n)
+    for (std::uint64_t l=0; l<=n; ++l)
+      for (std::uint64_t j=0; j<3; ++j)
+        labels.push_back(label_type(j,n,l));
+
+  ////////////////////////////////////////////////////////////////
+  // set
+  ////////////////////////////////////////////////////////////////
+
+  mcutils::BitTupleSet<label_type> set;
+  bool set_ok = true;
+  for (const label_type& label : labels)
+    set_ok &= set.insert(label);
+  set_ok &= !set.insert(labels[0]) && (set.size()==labels.size());
+  for (const label_type& label : labels)
+    set_ok &= set.contains(label);
+  set_ok &= !set.contains(label_type(std::uint64_t(3),std::uint64_t(0),std::uint64_t(0)));
+
+  std::size_t count = 0;
+  for (const label_type& label : set)
+    {
+      set_ok &= (std::uint64_t(mcutils::get<1>(label))>=std::uint64_t(mcutils::get<2>(label)));
+      ++count;
+    }
+  set_ok &= (count==labels.size());
+  std::cout << "set " << set.size() << "/" << set.capacity() << " " << (set_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= set_ok;
+
+  ////////////////////////////////////////////////////////////////
+  // map
+  ////////////////////////////////////////////////////////////////
+
+  mcutils::BitTupleMap<label_type,std::size_t> map;
+  std::unordered_map<label_type,std::size_t> reference;
+  for (std::size_t i=0; i<labels.size(); ++i)
+    {
+      map[labels[i]] = i;
+      reference[labels[i]] = i;
+    }
+
+  // erase every third entry, then reinsert some with new values
+  for (std::size_t i=0; i<labels.size(); i+=3)
+    {
+      map.erase(labels[i]);
+      reference.erase(labels[i]);
+    }
+  for (std::size_t i=0; i<labels.size(); i+=6)
+    {
+      map.insert(labels[i],2*i);
+      reference.insert({labels[i],2*i});
+    }
+  bool map_ok = !map.insert(labels[1],0) && !map.erase(labels[3]);
+
+  map_ok &= (map.size()==reference.size());
+  for (const label_type& label : labels)
+    {
+      const std::size_t* value_ptr = map.find(label);
+      auto it = reference.find(label);
+      map_ok &= (it==reference.end()) ? (value_ptr==nullptr) : (value_ptr && (*value_ptr==it->second));
+    }
+  for (const auto& [label, value] : map)
+    map_ok &= (reference.at(label)==value);
+  std::cout << "map " << map.size() << "/" << map.capacity() << " " << (map_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= map_ok;
+
+  // bool values are stored unpacked, so are addressable
+  mcutils::BitTupleMap<label_type,bool> flags;
+  for (std::size_t i=0; i<labels.size(); ++i)
+    flags[labels[i]] = (i%2==0);
+  bool* flag_ptr = flags.find(labels[3]);
+  bool flags_ok = flag_ptr && !*flag_ptr;
+  *flag_ptr = true;
+  flags_ok &= *flags.find(labels[3]) && *flags.find(labels[4])
+    && !flags.find(label_type(std::uint64_t(3),std::uint64_t(0),std::uint64_t(0)));
+  flags_ok &= !flags.insert(labels[5],true) && !flags[labels[5]];
+  std::size_t num_set = 0;
+  for (const auto& [label, flag] : flags)
+    num_set += flag;
+  flags_ok &= (num_set==(labels.size()+1)/2+1);
+  std::cout << "bool map " << (flags_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= flags_ok;
+
+#if defined(__SIZEOF_INT128__)
+  // 128-bit keys differing only in high word
+  typedef mcutils::bit_tuple<mcutils::uint128_t,60,68> wide_type;
+  mcutils::BitTupleMap<wide_type,int> wide_map;
+  for (int i=0; i<1000; ++i)
+    wide_map[wide_type(std::uint64_t(i),std::uint64_t(0))] = i;
+  bool wide_ok = (wide_map.size()==1000);
+  for (int i=0; i<1000; ++i)
+    wide_ok &= (*wide_map.find(wide_type(std::uint64_t(i),std::uint64_t(0)))==i);
+  wide_ok &= !wide_map.find(wide_type(std::uint64_t(0),std::uint64_t(1)));
+  std::cout << "wide map " << (wide_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= wide_ok;
+#endif
+
+  map.clear();
+  success &= map.empty() && !map.find(labels[1]);
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+  std::cout << "****" << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,215 @@
+/******************************************************************************
+
+  bit_tuple_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/bit_tuple.h"
+#include "mcutils/bit_tuple_algorithm.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+// label with named fields
+typedef mcutils::bit_tuple<std::uint32_t,8,8,16> label_type;
+constexpr mcutils::bit_tuple_field<label_type,0> kN{};
+constexpr mcutils::bit_tuple_field<label_type,1> kL{};
+constexpr mcutils::bit_tuple_field<label_type,2> kM{};
+
+// field layout is available at compile time
+static_assert(kN.offset==24 && kN.size==8 && kN.mask_value==0xFF000000u);
+static_assert(kM.offset==0 && kM.size==16 && kM.max_value==0xFFFFu);
+static_assert(mcutils::bit_tuple_traits<label_type>::total_size==32);
+
+// pack and unpack are constexpr
+static_assert(
+    mcutils::pack_bit_tuple<label_type>(std::make_tuple(1,2,3)).bitrep()==0x01020003u
+  );
+static_assert(
+    std::get<2>(mcutils::unpack_bit_tuple(label_type::from_bitrep(0x01020003u)))==3u
+  );
+
+int main(int argc, char **argv)
+{
+  bool success = true;
+
+  ////////////////////////////////////////////////////////////////
+  // construction and element access
+  ////////////////////////////////////////////////////////////////
+
+  label_type t1(std::uint32_t(1),std::uint32_t(2),std::uint32_t(3));
+  label_type t2;
+  mcutils::get<0>(t2) = 1u;
+  mcutils::get<1>(t2) = mcutils::get<1>(t1);
+  mcutils::get<2>(t2) = 3u;
+  std::cout << std::hex << t1.bitrep() << " " << t2.bitrep() << std::dec << std::endl;
+  success &= (t1==t2) && (t1.bitrep()==0x01020003u) && (t1==label_type::from_bitrep(t1.bitrep()));
+  success &= (std::hash<label_type>()(t1)==std::hash<label_type>()(t2));
+
+  // copy between fields of different offset
+  mcutils::get<0>(t2) = mcutils::get<1>(t1);
+  success &= (std::uint32_t(mcutils::get<0>(t2))==2u);
+
+  ////////////////////////////////////////////////////////////////
+  // named access
+  ////////////////////////////////////////////////////////////////
+
+  label_type label(std::uint32_t(4),std::uint32_t(2),std::uint32_t(1000));
+  std::cout << mcutils::get(label,kN) << " " << mcutils::get(label,kL) << " "
+            << mcutils::get(label,kM) << std::endl;
+  success &= (mcutils::get(label,kM)==std::uint32_t(mcutils::get<2>(label)));
+
+  mcutils::set(label,kL,7);
+  mcutils::set(label,kM,0x1FFFF);  // truncated to field
+  std::cout << mcutils::get(label,kN) << " " << mcutils::get(label,kL) << " "
+            << mcutils::get(label,kM) << std::endl;
+  success &= (label==label_type(std::uint32_t(4),std::uint32_t(7),std::uint32_t(0xFFFF)));
+
+  ////////////////////////////////////////////////////////////////
+  // pack and unpack
+  ////////////////////////////////////////////////////////////////
+
+  bool packing_ok = true;
+  for (int n=0; n<4; ++n)
+    for (int l=0; l<=n; ++l)
+      for (int m=-l; m<=l; ++m)
+        {
+          label_type t = mcutils::pack_bit_tuple<label_type>(std::make_tuple(n,l,std::uint16_t(m)));
+          auto [n1,l1,m1] = mcutils::unpack_bit_tuple(t);
+          packing_ok &= (t==label_type(std::uint32_t(n),std::uint32_t(l),std::uint32_t(std::uint16_t(m))));
+          packing_ok &= (int(n1)==n) && (int(l1)==l) && (std::int16_t(m1)==m);
+        }
+
+  // full-width field
+  typedef mcutils::bit_tuple<std::uint64_t,64> word_type;
+  word_type word = mcutils::pack_bit_tuple<word_type>(std::make_tuple(~std::uint64_t(0)));
+  packing_ok &= (std::get<0>(mcutils::unpack_bit_tuple(word))==~std::uint64_t(0));
+
+  std::cout << "packing " << (packing_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= packing_ok;
+
+  ////////////////////////////////////////////////////////////////
+  // bulk pack and unpack
+  ////////////////////////////////////////////////////////////////
+
+  std::vector<std::uint8_t> n_column, l_column;
+  std::vector<std::int16_t> m_column;
+  for (int n=0; n<20; ++n)
+    for (int l=0; l<=n; ++l)
+      for (int m=-l; m<=l; ++m)
+        {
+          n_column.push_back(n);
+          l_column.push_back(l);
+          m_column.push_back(m);
+        }
+  std::vector<label_type> labels = mcutils::pack_bit_tuples<label_type>(n_column,l_column,m_column);
+
+  std::vector<std::uint8_t> n_column_out, l_column_out;
+  std::vector<std::int16_t> m_column_out;
+  mcutils::unpack_bit_tuples(labels,n_column_out,l_column_out,m_column_out);
+  std::vector<std::uint32_t> l_extracted = mcutils::extract_bit_tuple_field<1>(labels);
+  std::vector<std::int16_t> m_extracted = mcutils::extract_bit_tuple_field<2,std::int16_t>(labels);
+
+  bool bulk_ok = (n_column_out==n_column) && (l_column_out==l_column) && (m_column_out==m_column)
+    && (m_extracted==m_column);
+  for (std::size_t i=0; i<labels.size(); ++i)
+    bulk_ok &= (labels[i]==mcutils::pack_bit_tuple<label_type>(
+        std::make_tuple(n_column[i],l_column[i],std::uint16_t(m_column[i]))
+      )) && (l_extracted[i]==l_column[i]);
+  std::cout << "bulk " << labels.size() << " " << (bulk_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= bulk_ok;
+
+  ////////////////////////////////////////////////////////////////
+  // radix sort and index
+  ////////////////////////////////////////////////////////////////
+
+  std::vector<label_type> shuffled = labels;
+  std::mt19937 generator(42);
+  std::shuffle(shuffled.begin(),shuffled.end(),generator);
+  auto bitrep_less = [](const label_type& a, const label_type& b) { return a.bitrep()<b.bitrep(); };
+
+  std::vector<label_type> sorted = shuffled, radix_sorted = shuffled;
+  std::sort(sorted.begin(),sorted.end(),bitrep_less);
+  mcutils::radix_sort_bit_tuples(radix_sorted);
+  bool sort_ok = (radix_sorted==sorted);
+
+  // by m, then n, stable in l
+  std::vector<label_type> field_sorted = shuffled;
+  std::stable_sort(
+      field_sorted.begin(),field_sorted.end(),
+      [](const label_type& a, const label_type& b)
+      {
+        return std::make_tuple(mcutils::get(a,kM),mcutils::get(a,kN))
+          < std::make_tuple(mcutils::get(b,kM),mcutils::get(b,kN));
+      }
+    );
+  radix_sorted = shuffled;
+  mcutils::radix_sort_bit_tuples_by_fields<2,0>(radix_sorted);
+  sort_ok &= (radix_sorted==field_sorted);
+  std::cout << "radix sort " << (sort_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= sort_ok;
+
+  shuffled.push_back(shuffled[0]);  // duplicate
+  mcutils::bit_tuple_index<label_type> index(shuffled);
+  bool index_ok = (index.size()==labels.size());
+  for (std::size_t i=0; i<labels.size(); ++i)
+    index_ok &= (index.find(sorted[i])==i) && (index[i]==sorted[i]);
+  index_ok &= !index.contains(label_type(std::uint32_t(3),std::uint32_t(4),std::uint32_t(0)));
+  index_ok &= !index.contains(label_type(std::uint32_t(200),std::uint32_t(0),std::uint32_t(0)));
+  index_ok &= (mcutils::bit_tuple_index<label_type>().find(labels[0])==index.npos);
+  std::cout << "index " << (index_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= index_ok;
+
+#if defined(__SIZEOF_INT128__)
+  ////////////////////////////////////////////////////////////////
+  // 128-bit storage
+  ////////////////////////////////////////////////////////////////
+
+  // middle field straddles 64-bit word boundary
+  typedef mcutils::bit_tuple<mcutils::uint128_t,40,40,40> wide_type;
+  static_assert(mcutils::bit_tuple_field<wide_type,1>::offset==40);
+  static_assert(sizeof(wide_type)==sizeof(mcutils::uint128_t));
+
+  const std::uint64_t big = (std::uint64_t(1)<<40)-3;
+  wide_type wide(std::uint64_t(5),big,std::uint64_t(7));
+  const mcutils::bit_tuple_field<wide_type,1> kWideMiddle{};
+  bool wide_ok = (std::uint64_t(mcutils::get(wide,kWideMiddle))==big)
+    && (std::uint64_t(mcutils::get<1>(wide))==big)
+    && (std::uint64_t(mcutils::get<0>(wide))==5);
+  mcutils::set(wide,kWideMiddle,big-1);
+  wide_ok &= (wide==mcutils::pack_bit_tuple<wide_type>(std::make_tuple(5,big-1,7)));
+  wide_ok &= (std::get<1>(mcutils::unpack_bit_tuple(wide))==big-1);
+
+  // ordering follows first field, held in high word
+  std::vector<wide_type> wides;
+  std::unordered_set<wide_type> wide_set;
+  for (std::uint64_t i=0; i<200; ++i)
+    {
+      wides.push_back(wide_type((i*7)%200,i<<20,i));
+      wide_set.insert(wides.back());
+    }
+  mcutils::radix_sort_bit_tuples(wides);
+  for (std::size_t i=0; i<wides.size(); ++i)
+    wide_ok &= (std::uint64_t(mcutils::get<0>(wides[i]))==i) && wide_set.count(wides[i]);
+  mcutils::bit_tuple_index<wide_type> wide_index(wides);
+  for (std::size_t i=0; i<wides.size(); ++i)
+    wide_ok &= (wide_index.find(wides[i])==i);
+  wide_ok &= (wide_set.size()==200) && !wide_set.count(wide);
+  std::cout << "wide " << (wide_ok ? "OK" : "MISMATCH") << std::endl;
+  success &= wide_ok;
+#endif
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+  std::cout << "****" << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,115 @@
+/******************************************************************************
+
+  bounded_memoizer_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/bounded_memoizer.h"
+
+#include <cstdlib>
+#include <iostream>
+
+template<typename tMemoizer>
+int Square(tMemoizer& m, int i)
+{
+  return MEMOIZE(m, i, (std::cout << "(" << i << ")", i*i));
+}
+
+template<typename tMemoizer>
+void PrintStatistics(const tMemoizer& m)
+{
+  std::cout << "size " << m.size() << "/" << m.capacity()
+            << " hits " << m.hits()
+            << " misses " << m.misses()
+            << " evictions " << m.evictions()
+            << " hit rate " << m.HitRate()
+            << std::endl;
+}
+
+bool TestLRU()
+{
+  std::cout << "LRU" << std::endl;
+  mcutils::BoundedMemoizer<int,int> m(3);
+
+  // fill, then touch 1, so 2 is least recently used
+  for (int i : {1,2,3,1})
+    std::cout << Square(m,i) << " ";
+  std::cout << std::endl;
+
+  // insertion of 4 should evict 2
+  std::cout << Square(m,4) << std::endl;
+  std::cout << m;
+  PrintStatistics(m);
+
+  return m.Known(1) && !m.Known(2) && m.Known(3) && m.Known(4)
+    && (m.hits()==1) && (m.misses()==4) && (m.evictions()==1);
+}
+
+bool TestClock()
+{
+  std::cout << "CLOCK" << std::endl;
+  mcutils::BoundedMemoizer<int,int,mcutils::ClockEvictionPolicy> m(3);
+
+  for (int i : {1,2,3})
+    std::cout << Square(m,i) << " ";
+  std::cout << std::endl;
+
+  // all slots referenced, so the sweep clears every reference bit and
+  // evicts slot 0 (key 1); then touching 2 protects it from the next sweep
+  std::cout << Square(m,4) << " " << Square(m,2) << " " << Square(m,5) << std::endl;
+  std::cout << m;
+  PrintStatistics(m);
+
+  return !m.Known(1) && m.Known(2) && !m.Known(3) && m.Known(4) && m.Known(5)
+    && (m.evictions()==2);
+}
+
+bool TestWorkingSet()
+{
+  std::cout << "Working set" << std::endl;
+
+  // a working set which fits in the cache should stop missing
+  mcutils::BoundedMemoizer<int,int> m(100);
+  long sum = 0;
+  for (int pass=0; pass<10; ++pass)
+    for (int i=0; i<100; ++i)
+      sum += MEMOIZE(m, i, i*i);
+  PrintStatistics(m);
+  bool success = (m.misses()==100) && (m.evictions()==0);
+
+  // cyclic access to a working set larger than the cache defeats LRU...
+  mcutils::BoundedMemoizer<int,int> m_lru(50);
+  for (int pass=0; pass<10; ++pass)
+    for (int i=0; i<100; ++i)
+      sum += MEMOIZE(m_lru, i, i*i);
+  PrintStatistics(m_lru);
+  success &= (m_lru.hits()==0);
+
+  // ...and a zero-capacity cache never stores anything
+  mcutils::BoundedMemoizer<int,int> m_zero(0);
+  for (int i=0; i<10; ++i)
+    sum += MEMOIZE(m_zero, i%2, i*i);
+  PrintStatistics(m_zero);
+  success &= (m_zero.size()==0);
+
+  std::cout << "(sum " << sum << ")" << std::endl;
+  return success;
+}
+
+int main(int argc, char **argv)
+{
+  bool success = true;
+  success &= TestLRU();
+  std::cout << "****" << std::endl;
+  success &= TestClock();
+  std::cout << "****" << std::endl;
+  success &= TestWorkingSet();
+  std::cout << "****" << std::endl;
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,125 @@
+/******************************************************************************
+
+  concurrent_memoizer_test.cpp
+
+  Multi-threaded stress test of ConcurrentMemoizer.
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/concurrent_memoizer.h"
+#include "mcutils/profiling.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// number of evaluations of each key, indexed by key
+std::vector<std::atomic<int>> evaluation_counts;
+
+long Square(int i)
+{
+  ++evaluation_counts[i];
+  return static_cast<long>(i)*i;
+}
+
+long Factorial(mcutils::ConcurrentMemoizer<int,long>& m, int i)
+// Recursive use: functor invokes GetOrCompute for other keys.
+{
+  if (i==0)
+    return 1;
+  return m.GetOrCompute(i, [&](){return (i*Factorial(m,i-1))%1000003;});
+}
+
+bool TestStress(int num_threads, int num_keys, int num_passes)
+{
+  std::cout << "Stress: " << num_threads << " threads, "
+            << num_keys << " keys, " << num_passes << " passes" << std::endl;
+
+  mcutils::ConcurrentMemoizer<int,long> m;
+  evaluation_counts = std::vector<std::atomic<int>>(num_keys);
+  std::atomic<int> wrong_values(0);
+
+  // all threads hammer the same keys, in staggered orders
+  mcutils::SteadyTimer timer;
+  timer.Start();
+  std::vector<std::thread> threads;
+  for (int t=0; t<num_threads; ++t)
+    threads.emplace_back(
+        [&,t]()
+        {
+          for (int pass=0; pass<num_passes; ++pass)
+            for (int j=0; j<num_keys; ++j)
+              {
+                int i = (j + t*7919 + pass*104729) % num_keys;
+                long value = m.GetOrCompute(i, [i](){return Square(i);});
+                if (value != static_cast<long>(i)*i)
+                  ++wrong_values;
+              }
+        }
+      );
+  for (auto& thread : threads)
+    thread.join();
+  timer.Stop();
+
+  int repeated = 0, missing = 0;
+  for (int i=0; i<num_keys; ++i)
+    {
+      if (evaluation_counts[i]>1)
+        ++repeated;
+      if (!m.Known(i))
+        ++missing;
+    }
+
+  std::cout << "  time " << timer.ElapsedTime()
+            << ", entries " << m.size()
+            << ", repeated evaluations " << repeated
+            << ", missing " << missing
+            << ", wrong values " << wrong_values << std::endl;
+
+  return (repeated==0) && (missing==0) && (wrong_values==0) && (m.size()==std::size_t(num_keys));
+}
+
+bool TestRecursive(int num_threads)
+{
+  std::cout << "Recursive: " << num_threads << " threads" << std::endl;
+
+  mcutils::ConcurrentMemoizer<int,long> m(4);
+  const int n_max = 2000;
+  std::vector<long> results(num_threads);
+  std::vector<std::thread> threads;
+  for (int t=0; t<num_threads; ++t)
+    threads.emplace_back([&,t](){results[t] = Factorial(m,n_max-t%3);});
+  for (auto& thread : threads)
+    thread.join();
+
+  // compare to serial evaluation
+  bool success = true;
+  for (int t=0; t<num_threads; ++t)
+    {
+      long expected = 1;
+      for (int i=1; i<=n_max-t%3; ++i)
+        expected = (i*expected)%1000003;
+      success &= (results[t]==expected);
+    }
+  std::cout << "  entries " << m.size() << ", success " << success << std::endl;
+
+  return success;
+}
+
+int main(int argc, char **argv)
+{
+  bool success = true;
+  success &= TestStress(1,10000,2);
+  success &= TestStress(8,10000,4);
+  success &= TestStress(64,20000,4);
+  success &= TestRecursive(16);
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
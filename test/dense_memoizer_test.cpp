@@ -0,0 +1,112 @@
+/******************************************************************************
+
+  dense_memoizer_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/dense_memoizer.h"
+#include "mcutils/profiling.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+int Factorial(int i)
+{
+  static mcutils::DenseMemoizer<int> m(0,10);
+
+  if (i==0)
+    return 1;
+  else
+    return MEMOIZE(m, i, (std::cout << "(" << i << ")", i*Factorial(i-1)));
+}
+
+typedef mcutils::DenseMemoizer<long,3> TripleMemoizer;
+
+long Triple(int a, int b, int c)
+{
+  static TripleMemoizer m({0,0,-5},{4,4,5});
+  return MEMOIZE(m, (TripleMemoizer::key_type{a,b,c}), (std::cout << "*", 100*a+10*b+c));
+}
+
+long Binomial(int n, int k)
+// Pascal's triangle recursion, via GetOrEmplace
+{
+  static mcutils::DenseMemoizer<long,2> m({0,0},{60,60});
+  if ((k==0)||(k==n))
+    return 1;
+  return m.GetOrEmplace({n,k}, [&](){return Binomial(n-1,k-1)+Binomial(n-1,k);});
+}
+
+bool TestTiming()
+{
+  const int n_max = 200;
+  const int num_passes = 100;
+  long x = 0, y = 0;
+
+  mcutils::DenseMemoizer<long,2> m_dense({0,0},{n_max,n_max});
+  mcutils::SteadyTimer dense_timer;
+  dense_timer.Start();
+  for (int pass=0; pass<num_passes; ++pass)
+    for (int i=0; i<=n_max; ++i)
+      for (int j=0; j<=n_max; ++j)
+        x += MEMOIZE(m_dense, (std::array<int,2>{i,j}), long(i)*j);
+  dense_timer.Stop();
+
+  mcutils::Memoizer<std::array<int,2>,long> m_map;
+  mcutils::SteadyTimer map_timer;
+  map_timer.Start();
+  for (int pass=0; pass<num_passes; ++pass)
+    for (int i=0; i<=n_max; ++i)
+      for (int j=0; j<=n_max; ++j)
+        y += MEMOIZE(m_map, (std::array<int,2>{i,j}), long(i)*j);
+  map_timer.Stop();
+
+  std::cout << "Time with DenseMemoizer: " << dense_timer.ElapsedTime() << ", result " << x << std::endl;
+  std::cout << "Time with Memoizer: " << map_timer.ElapsedTime() << ", result " << y << std::endl;
+  return (x==y);
+}
+
+int main(int argc, char **argv)
+{
+  bool success = true;
+
+  std::cout << "One-dimensional..." << std::endl;
+  for (int i : {5,3,10,11,10})
+    std::cout << Factorial(i) << std::endl;
+  // 11 is out of bounds, so never cached
+  std::cout << Factorial(11) << std::endl;
+  std::cout << "****" << std::endl;
+
+  std::cout << "Three-dimensional..." << std::endl;
+  std::cout << Triple(1,2,3) << " " << Triple(1,2,-3) << " " << Triple(1,2,3) << " "
+            << Triple(4,4,5) << " " << Triple(5,0,0) << " " << Triple(5,0,0) << std::endl;
+  std::cout << "****" << std::endl;
+
+  std::cout << "GetOrEmplace..." << std::endl;
+  std::cout << Binomial(10,5) << " " << Binomial(60,30) << std::endl;
+  success &= (Binomial(10,5)==252) && (Binomial(60,30)==118264581564861424L);
+  std::cout << "****" << std::endl;
+
+  std::cout << "Cache dump..." << std::endl;
+  mcutils::DenseMemoizer<double,2> m({-1,-1},{1,1});
+  m.SetValue({-1,1}, 0.5);
+  m.SetValue({1,0}, 2.5);
+  m.SetValue({2,0}, 9.);
+  std::cout << m;
+  std::cout << "size " << m.size() << " capacity " << m.capacity() << std::endl;
+  success &= (m.size()==2) && m.Known({1,0}) && !m.Known({0,0}) && !m.InRange({2,0});
+  m.clear();
+  success &= (m.size()==0) && !m.Known({1,0});
+  std::cout << "****" << std::endl;
+
+  success &= TestTiming();
+  std::cout << "****" << std::endl;
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
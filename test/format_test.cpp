@@ -0,0 +1,69 @@
+/******************************************************************************
+
+  format_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/format.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+int main(int argc, char **argv)
+{
+  bool success = true;
+
+  // fundamental types
+  std::string buffer;
+  mcutils::AppendText(buffer,-42);
+  mcutils::AppendText(buffer," ");
+  mcutils::AppendText(buffer,0.25);
+  mcutils::AppendText(buffer,' ');
+  mcutils::AppendText(buffer,std::string("abc"));
+  mcutils::AppendText(buffer," ");
+  mcutils::AppendText(buffer,18446744073709551615ULL);
+  std::cout << buffer << std::endl;
+  success &= (buffer=="-42 0.25 abc 18446744073709551615");
+
+  // tuple and memoizer via fmt
+  mcutils::VectorTuple<int,3> x(std::vector<int>({1,-2,3}));
+  mcutils::Memoizer<mcutils::VectorTuple<int,3>,double> m;
+  m.SetValue(x,0.5);
+  m.SetValue(2*x,1.5);
+  std::string text = fmt::format("{} | {}", x, m);
+  std::cout << text;
+  std::ostringstream os;
+  os << x << " | " << m;
+  success &= (text==os.str());
+
+  // floating point is shortest round trip, not stream precision
+  mcutils::VectorTuple<double,2> y(std::vector<double>({0.1+0.2,1./3}));
+  std::string y_text = fmt::format("{}",y);
+  std::ostringstream y_os;
+  y_os << y;
+  std::cout << y_text << " " << y_os.str() << std::endl;
+  success &= (y_text!=y_os.str()) && (y_text.find("0.30000000000000004")!=std::string::npos);
+
+  // bulk writer, across several blocks
+  std::ostringstream os_fast, os_slow;
+  {
+    mcutils::TextWriter writer(os_fast,100);
+    for (int i=0; i<1000; ++i)
+      {
+        writer << i << " " << x*i << "\n";
+        os_slow << i << " " << x*i << "\n";
+      }
+  }
+  success &= (os_fast.str()==os_slow.str());
+  std::cout << "writer " << os_fast.str().size() << " bytes" << std::endl;
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+  std::cout << "****" << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+/******************************************************************************
+
+  frozen_memoizer_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/frozen_memoizer.h"
+#include "mcutils/memoizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+double Slow(int i)
+// Mock "expensive" function, with cost varying over domain.
+{
+  double y = 0.;
+  for (int k=0; k<=(i%97)*100; ++k)
+    y += std::sin(k*1e-3);
+  return y+i;
+}
+
+int main(int argc, char **argv)
+{
+  bool success = true;
+
+  ////////////////////////////////////////////////////////////////
+  // precompute over domain
+  ////////////////////////////////////////////////////////////////
+
+  // domain (deliberately unsorted and with duplicates)
+  std::vector<int> domain;
+  for (int i=9999; i>=0; --i)
+    domain.push_back(i);
+  for (int i=0; i<100; ++i)
+    domain.push_back(i);
+
+  for (int num_threads : {1,4,0})
+    {
+      auto table = mcutils::Precompute(domain, Slow, num_threads);
+      bool ok = (table.size()==10000);
+      for (int i=0; i<10000; ++i)
+        ok &= (table.Find(i)!=nullptr) && (*table.Find(i)==Slow(i));
+      ok &= !table.Known(-1) && !table.Known(10000);
+      ok &= (table.GetOrCompute(-1,[](){return -1.;})==-1.);
+      std::cout << "threads " << num_threads << " size " << table.size()
+                << " " << (ok ? "OK" : "MISMATCH") << std::endl;
+      success &= ok;
+    }
+
+  ////////////////////////////////////////////////////////////////
+  // concurrent read-only lookups
+  ////////////////////////////////////////////////////////////////
+
+  {
+    std::vector<std::string> words = {"alpha","beta","gamma","delta"};
+    const auto table = mcutils::Precompute(words, [](const std::string& s){return s.size();}, 2);
+    std::vector<std::size_t> totals(4,0);
+    std::vector<std::thread> threads;
+    for (int t=0; t<4; ++t)
+      threads.emplace_back(
+          [&table,&words,&totals,t]()
+          {
+            for (int pass=0; pass<1000; ++pass)
+              for (const auto& word : words)
+                totals[t] += *table.Find(word);
+          }
+        );
+    for (auto& thread : threads)
+      thread.join();
+    bool ok = true;
+    for (std::size_t total : totals)
+      ok &= (total==1000*(5+4+5+5));
+    std::cout << "concurrent lookup " << (ok ? "OK" : "MISMATCH") << std::endl;
+    success &= ok;
+  }
+
+  ////////////////////////////////////////////////////////////////
+  // lookup against std::binary_search for all small table sizes
+  ////////////////////////////////////////////////////////////////
+
+  {
+    bool ok = true;
+    for (int n=0; n<=40; ++n)
+      {
+        // odd keys 1,3,...,2n-1
+        std::vector<int> keys, values;
+        for (int i=0; i<n; ++i)
+          {
+            keys.push_back(2*i+1);
+            values.push_back(i);
+          }
+        mcutils::FrozenMemoizer<int,int> table(keys,values);
+        for (int x=-1; x<=2*n+1; ++x)
+          {
+            const int* y = table.Find(x);
+            const bool expected = std::binary_search(keys.begin(),keys.end(),x);
+            ok &= (expected ? (y && (*y==(x-1)/2)) : (y==nullptr));
+          }
+      }
+    std::cout << "branchless search " << (ok ? "OK" : "MISMATCH") << std::endl;
+    success &= ok;
+  }
+
+  ////////////////////////////////////////////////////////////////
+  // freeze memoizer
+  ////////////////////////////////////////////////////////////////
+
+  {
+    mcutils::Memoizer<int,double> m;
+    for (int i=20; i>0; i-=3)
+      m.SetValue(i,0.5*i);
+    auto frozen = m.Freeze();
+
+    // iteration
+    bool ok = (frozen.size()==m.size());
+    auto mit = m.begin();
+    for (auto it = frozen.begin(); it != frozen.end(); ++it, ++mit)
+      ok &= (it->first==mit->first) && ((*it).second==mit->second);
+    for (const auto& entry : frozen)
+      ok &= (*frozen.Find(entry.first)==entry.second);
+
+    // output matches memoizer output
+    std::ostringstream os_memoizer, os_frozen;
+    os_memoizer << m;
+    os_frozen << frozen;
+    ok &= (os_memoizer.str()==os_frozen.str());
+    std::cout << "frozen memoizer" << std::endl << frozen;
+    mcutils::FrozenMemoizer<int,double>::SetDelimiters("","=",";");
+    std::cout << frozen << std::endl;
+
+    std::cout << "freeze " << (ok ? "OK" : "MISMATCH") << std::endl;
+    success &= ok;
+  }
+
+  ////////////////////////////////////////////////////////////////
+  // exception propagation
+  ////////////////////////////////////////////////////////////////
+
+  {
+    bool caught = false;
+    try
+      {
+        mcutils::Precompute(
+            domain,
+            [](int i){if (i==5000) throw std::runtime_error("bad key"); return i;},
+            4
+          );
+      }
+    catch (const std::runtime_error& e)
+      {
+        caught = true;
+        std::cout << "caught: " << e.what() << std::endl;
+      }
+    success &= caught;
+  }
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+  std::cout << "****" << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -6,8 +6,11 @@
 
 ****************************************************************/
 
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "mcutils/io.h"
 
@@ -30,6 +33,18 @@ int main(int argc, char **argv)
 
   std::cout << out_stream.str() << std::endl;
 
+  // memory-mapped readback
+  const std::string filename = "io_test.bin";
+  {
+    std::ofstream file_stream(filename,std::ios_base::out|std::ios_base::binary);
+    file_stream << out_stream.str();
+  }
+  mcutils::MappedFile mapped_file(filename);
+  std::cout << "mapped " << mapped_file.is_open() << " size " << mapped_file.size() << std::endl;
+  std::cout << std::string(mapped_file.data(),mapped_file.size()) << std::endl;
+  mapped_file.close();
+  std::remove(filename.c_str());
+
 
   // termination
   return EXIT_SUCCESS;
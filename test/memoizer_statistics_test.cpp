@@ -0,0 +1,125 @@
+/******************************************************************************
+
+  memoizer_statistics_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+// enable statistics collection for this test, regardless of build option
+#ifndef MCUTILS_MEMOIZER_STATISTICS
+#define MCUTILS_MEMOIZER_STATISTICS
+#endif
+
+#include "mcutils/memoizer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+int Factorial(int i)
+{
+  static mcutils::Memoizer<int,int> m;
+  m.SetName("factorial");
+
+  if (i==0)
+    return 1;
+  else
+    return MEMOIZE(m, i, i*Factorial(i-1));
+}
+
+long Square(long i)
+{
+  static mcutils::HashMemoizer<long,long> m;
+  m.SetName("square (hash)");
+
+  return m.GetOrEmplace(i, [&](){return i*i;});
+}
+
+int main(int argc, char **argv)
+{
+  // report is printed after main returns, including function-local
+  // static memoizers destroyed at exit
+  mcutils::ReportMemoizerStatisticsAtExit();
+
+  // cold cache: every call below 10 is a hit after the first
+  int x = 0;
+  for (int i=1; i<=10; ++i)
+    x += Factorial(i);
+
+  // repeated keys
+  long y = 0;
+  for (int pass=0; pass<4; ++pass)
+    for (long i=0; i<1000; ++i)
+      y += Square(i);
+
+  // unused memoizer
+  mcutils::Memoizer<int,double> cold;
+  cold.SetName("cold");
+
+  // copied memoizer gets its own record
+  mcutils::Memoizer<int,int> original;
+  original.SetName("original");
+  original.SetValue(1,1);
+  mcutils::Memoizer<int,int> copy(original);
+  MEMOIZE(copy, 1, 0);
+
+  // moved memoizer keeps its record, and destroyed memoizers leave the
+  // live registry
+  std::size_t num_live = mcutils::impl::GetMemoizerStatisticsRegistry().records.size();
+  mcutils::Memoizer<int,int> moved(std::move(copy));
+  for (int pass=0; pass<3; ++pass)
+    {
+      mcutils::Memoizer<int,int> temporary;
+      temporary.SetName("temporary");
+      MEMOIZE(temporary, pass, pass);
+    }
+  mcutils::ReportMemoizerStatisticsAtExit();  // repeated registration has no effect
+
+  // compute time keeps accumulating after a computation throws
+  bool timing_ok = true;
+  {
+    auto slow = [](int i)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        if (i<0)
+          throw std::domain_error("negative");
+        return i;
+      };
+    mcutils::Memoizer<int,int> timed;
+    mcutils::HashMemoizer<int,int> timed_hash;
+    timed.SetName("timed");
+    timed_hash.SetName("timed");
+    for (int i : {-1,1,-2,2})
+      {
+        const double time = timed.statistics().compute_time;
+        const double time_hash = timed_hash.statistics().compute_time;
+        try {timed.GetOrEmplace(i,[&](){return slow(i);});} catch (const std::domain_error&) {}
+        try {timed_hash.GetOrEmplace(i,[&](){return slow(i);});} catch (const std::domain_error&) {}
+        timing_ok &= (timed.statistics().compute_time>time) && (timed_hash.statistics().compute_time>time_hash);
+      }
+    timing_ok &= (timed.size()==2) && (timed_hash.size()==2);
+  }
+  std::cout << "timing after exception " << (timing_ok ? "OK" : "MISMATCH") << std::endl;
+
+  std::cout << "x " << x << " y " << y << std::endl;
+  mcutils::PrintMemoizerStatistics(std::cout);
+
+  // check counters
+  const mcutils::MemoizerStatistics& statistics = moved.statistics();
+  bool success = (statistics.lookups==1) && (statistics.hits==1) && (statistics.entries==1);
+  success &= (statistics.name=="original (copy)");
+  success &= (mcutils::impl::GetMemoizerStatisticsRegistry().records.size()==num_live);
+  const std::vector<mcutils::MemoizerStatistics>& retired = mcutils::impl::GetMemoizerStatisticsRegistry().retired;
+  success &= (retired.size()==2) && (retired[0].name=="temporary") && (retired[0].lookups==3);
+  success &= (retired[1].name=="timed") && (retired[1].misses==8);
+  success &= (cold.statistics().lookups==0);
+  success &= timing_ok;
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+  std::cout << "****" << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
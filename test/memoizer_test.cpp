@@ -2,13 +2,24 @@
 
   Created by M. A. Caprio, 2/23/11.
   Patch include path 7/4/16.
+  Add HashMemoizer tests 10/17/26.
+  Add GetOrEmplace tests 10/17/26.
+  Add snapshot tests 10/17/26.
 
 ******************************************************************************/
 
 #include "mcutils/memoizer.h"
+#include "mcutils/bit_tuple.h"
 #include "mcutils/profiling.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include "am/halfint.h"
 
 using namespace std;
@@ -65,6 +76,70 @@ int factorial_cached(int i)
 
 }
 
+int factorial_hash_cached(int i)
+{
+
+	static mcutils::HashMemoizer<int,int> m;
+
+	if (i==0)
+		return 1;
+	else
+		return MEMOIZE(m, i, (cout << "(" << i << ")", i*factorial_hash_cached(i-1)) );
+
+}
+
+int sum_bit_tuple(const mcutils::bit_tuple<unsigned int,8,8>& t)
+{
+
+	static mcutils::HashMemoizer<mcutils::bit_tuple<unsigned int,8,8>,int> m;
+
+	return MEMOIZE(m, t, (cout << "(*)", int(mcutils::get<0>(t))+int(mcutils::get<1>(t))));
+
+}
+
+int factorial_emplace(int i)
+{
+
+	static mcutils::Memoizer<int,int> m;
+
+	if (i==0)
+		return 1;
+	else
+		return m.GetOrEmplace(i, [&](){cout << "(" << i << ")"; return i*factorial_emplace(i-1);});
+
+}
+
+int factorial_hash_emplace(int i)
+{
+
+	static mcutils::HashMemoizer<int,int> m;
+
+	if (i==0)
+		return 1;
+	else
+		return m.GetOrEmplace(i, [&](){cout << "(" << i << ")"; return i*factorial_hash_emplace(i-1);});
+
+}
+
+// value type which counts its copies
+struct CopyCounter
+{
+	static int copies;
+	int value;
+	CopyCounter(int v) : value(v) {}
+	CopyCounter(const CopyCounter& c) : value(c.value) {++copies;}
+	CopyCounter(CopyCounter&& c) = default;
+	CopyCounter& operator=(const CopyCounter& c) {value = c.value; ++copies; return *this;}
+};
+int CopyCounter::copies = 0;
+
+// transparent hash for heterogeneous lookup by string_view
+struct StringHash
+{
+	typedef void is_transparent;
+	std::size_t operator()(std::string_view s) const {return std::hash<std::string_view>()(s);}
+};
+
 int factorial_dump(int i)
 {
 
@@ -118,6 +193,18 @@ int factorial_cached_timing(int i)
 
 }
 
+int factorial_hash_cached_timing(int i)
+{
+
+	static mcutils::HashMemoizer<int,int> m;
+
+	if (i==0)
+		return 1;
+	else
+		return MEMOIZE(m, i, (i*factorial_hash_cached_timing(i-1)) );
+
+}
+
 int main(int argc, char **argv)
 {
 
@@ -151,10 +238,140 @@ int main(int argc, char **argv)
 	cout << factorial_cached(5) << endl;
 	cout << "****" << endl;
 
+	cout << "With hash caching..." << endl;
+	for (int i = 1; i<=5; ++i)
+		cout << factorial_hash_cached(i) << endl;
+	cout << factorial_hash_cached(10) << endl;
+	cout << factorial_hash_cached(5) << endl;
+	cout << "****" << endl;
+
+	cout << "With GetOrEmplace..." << endl;
+	for (int i = 1; i<=5; ++i)
+		cout << factorial_emplace(i) << endl;
+	cout << factorial_emplace(10) << endl;
+	cout << factorial_emplace(5) << endl;
+	for (int i = 1; i<=5; ++i)
+		cout << factorial_hash_emplace(i) << endl;
+	cout << factorial_hash_emplace(10) << endl;
+	cout << factorial_hash_emplace(5) << endl;
+	cout << "****" << endl;
+
+	cout << "Reference stability on hits..." << endl;
+	{
+		// hits (at every fill level, including just below growth) must
+		// not grow the table and move existing entries
+		mcutils::HashMemoizer<int,int> m_hash;
+		bool stable = true;
+		for (int n = 0; n<100; ++n)
+			{
+				const int* inserted = &m_hash.GetOrEmplace(n, [&](){return n;});
+				for (int i = 0; i<=n; ++i)
+					{
+						stable &= (m_hash.GetOrEmplace(i, [](){return -1;})==i);
+						m_hash.SetValue(i, -1);
+					}
+				stable &= (&m_hash.GetOrEmplace(n, [](){return -1;})==inserted);
+			}
+		cout << "stable " << stable << endl;
+	}
+	cout << "****" << endl;
+
+	cout << "Copies per lookup..." << endl;
+	{
+		mcutils::Memoizer<int,CopyCounter> m_copy;
+		for (int pass = 0; pass<2; ++pass)
+			for (int i = 1; i<=10; ++i)
+				MEMOIZE(m_copy, i, CopyCounter(i));
+		cout << "MEMOIZE: " << CopyCounter::copies << " copies" << endl;
+		CopyCounter::copies = 0;
+		m_copy.clear();
+		for (int pass = 0; pass<2; ++pass)
+			for (int i = 1; i<=10; ++i)
+				m_copy.GetOrEmplace(i, [&](){return CopyCounter(i);});
+		cout << "GetOrEmplace: " << CopyCounter::copies << " copies" << endl;
+	}
+	cout << "****" << endl;
+
+	cout << "Heterogeneous lookup..." << endl;
+	{
+		mcutils::Memoizer<std::string,std::size_t,std::less<>> m_string;
+		mcutils::HashMemoizer<std::string,std::size_t,StringHash,std::equal_to<>> m_string_hash;
+		for (std::string_view s : {"alpha", "beta", "alpha", "gamma", "beta"})
+			{
+				cout << m_string.GetOrEmplace(s, [&](){cout << "(" << s << ")"; return s.size();}) << " ";
+				cout << m_string_hash.GetOrEmplace(s, [&](){cout << "(" << s << ")"; return s.size();}) << endl;
+			}
+		cout << m_string;
+	}
+	cout << "****" << endl;
+
+	cout << "Snapshot..." << endl;
+	{
+		const std::string snapshot_filename = "memoizer_test_snapshot.bin";
+		mcutils::Memoizer<int,double> m_save;
+		for (int i = 1; i<=1000; ++i)
+			m_save.SetValue(i, 1./i);
+		m_save.SaveSnapshot(snapshot_filename);
+
+		mcutils::Memoizer<int,double> m_load;
+		m_load.SetValue(1, -1.);
+		bool loaded = m_load.LoadSnapshot(snapshot_filename);
+		cout << "loaded " << loaded << " size " << m_load.size()
+		     << " m[1] " << MEMOIZE(m_load, 1, 0.)
+		     << " m[4] " << MEMOIZE(m_load, 4, 0.) << endl;
+
+		// snapshot for different value type must be rejected
+		mcutils::Memoizer<int,float> m_wrong_type;
+		loaded = m_wrong_type.LoadSnapshot(snapshot_filename);
+		cout << "loaded wrong type " << loaded << " size " << m_wrong_type.size() << endl;
+
+		// read-only table directly from snapshot arrays
+		mcutils::FrozenMemoizer<int,double> frozen;
+		loaded = mcutils::LoadFrozenSnapshot(snapshot_filename, frozen);
+		cout << "loaded frozen " << loaded << " size " << frozen.size()
+		     << " m[4] " << *frozen.Find(4) << " m[1001] " << frozen.Known(1001) << endl;
+
+		// corrupt entry count, chosen so that the section sizes wrap
+		// around to match the file size, must be rejected
+		{
+			std::fstream file(snapshot_filename,std::ios_base::in|std::ios_base::out|std::ios_base::binary);
+			const std::uint64_t bad_count = 1000+(std::uint64_t(1)<<62);
+			file.seekp(offsetof(mcutils::impl::MemoizerSnapshotHeader,count));
+			file.write(reinterpret_cast<const char*>(&bad_count),sizeof(bad_count));
+		}
+		mcutils::Memoizer<int,double> m_corrupt;
+		loaded = m_corrupt.LoadSnapshot(snapshot_filename);
+		cout << "loaded corrupt " << loaded << " size " << m_corrupt.size() << endl;
+		loaded = mcutils::LoadFrozenSnapshot(snapshot_filename, frozen);
+		cout << "loaded corrupt frozen " << loaded << " size " << frozen.size() << endl;
+
+		std::remove(snapshot_filename.c_str());
+		cout << "loaded missing " << m_load.LoadSnapshot(snapshot_filename) << endl;
+	}
+	cout << "****" << endl;
+
+	cout << "Hash caching with bit_tuple key..." << endl;
+	cout << sum_bit_tuple({1u,2u}) << endl;
+	cout << sum_bit_tuple({3u,4u}) << endl;
+	cout << sum_bit_tuple({1u,2u}) << endl;
+	cout << "****" << endl;
+
 	cout << "Cache dump..." << endl;
 	factorial_dump(10);
 	cout << "****" << endl;
 
+	cout << "Bulk text dump..." << endl;
+	{
+		mcutils::Memoizer<int,double> m;
+		for (int i = 0; i<100000; ++i)
+			m.SetValue(i,0.5*i);  // exact in default stream precision
+		std::ostringstream os_slow, os_fast;
+		os_slow << m;
+		mcutils::WriteText(os_fast,m);
+		cout << "matches operator<< " << (os_fast.str()==os_slow.str()) << ", " << os_fast.str().size() << " bytes" << endl;
+	}
+	cout << "****" << endl;
+
 	mcutils::Timer t;
 	int x;
 	int n_max = 10000;
@@ -180,6 +397,13 @@ int main(int argc, char **argv)
 	t.Stop();
 	cout << "Time with caching: " << t.ElapsedTime() << ",  result " << x  << endl;
 
+	t.Start();
+	x=0;
+	for (int i = 1; i<=n_max; ++i)
+		x+= factorial_hash_cached_timing(i);
+	t.Stop();
+	cout << "Time with hash caching: " << t.ElapsedTime() << ",  result " << x  << endl;
+
 	// On mac 2/23/11:
 	// for n_max = 10000;
 	// Time without caching: 0.469,  result -125961703
@@ -6,7 +6,17 @@
 
 ****************************************************************/
 
+// enable profiling regions for this test, regardless of build option
+#ifndef MCUTILS_PROFILING
+#define MCUTILS_PROFILING
+#endif
+
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
 
 #include "mcutils/profiling.h"
 
@@ -72,14 +82,125 @@ void CompareTimers()
   std::cout << std::endl;
 }
 
+bool TestCycleTimer()
+{
+  // cycle counter timer, against steady_clock timer
+  //
+  // Both time a sleep of half a second, rather than a short busy loop,
+  // so that the interval is long compared to scheduling jitter and to
+  // error in the calibrated counter frequency, and the tolerance is
+  // still generous, since the test may run on a loaded machine.
+  std::cout << "CycleTimer" << std::endl;
+  std::cout << "(Cycle counter " << (MCUTILS_HAS_CYCLE_COUNTER ? "hardware" : "steady_clock")
+            << ", " << mcutils::CycleCounterFrequency()/1e9 << " GHz)" << std::endl;
+
+  mcutils::CycleTimer cycle_timer;
+  mcutils::SteadyTimer steady_timer;
+  cycle_timer.Start();
+  steady_timer.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  cycle_timer.Stop();
+  steady_timer.Stop();
+  std::cout << "(Time: cycle_timer " << cycle_timer.ElapsedTime() << " (" << cycle_timer.ElapsedTicks() << " ticks)"
+            << ", steady_timer " << steady_timer.ElapsedTime() << ")" << std::endl;
+
+  const double ratio = cycle_timer.ElapsedTime()/steady_timer.ElapsedTime();
+  bool success = (ratio>0.75) && (ratio<1.25);
+  cycle_timer.Reset();
+  success &= (cycle_timer.ElapsedTicks()==0);
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+
+  std::cout << std::endl;
+  return success;
+}
+
+bool TestPerfCounterGroup()
+{
+  // hardware counters (or wall time only, if unavailable)
+  std::cout << "PerfCounterGroup" << std::endl;
+
+  mcutils::PerfCounterGroup counters;
+  counters.Start();
+  DoDelay();
+  counters.Stop();
+  counters.Print(std::cout);
+
+  bool success = (counters.ElapsedTime()>0);
+  if (counters.Available(mcutils::PerfCounterGroup::kCycles) && counters.Available(mcutils::PerfCounterGroup::kInstructions))
+    success &= (counters.IPC()>0);
+  else
+    success &= std::isnan(counters.IPC());
+  counters.Reset();
+  success &= (counters.ElapsedTime()==0);
+  if (counters.Available(mcutils::PerfCounterGroup::kInstructions))
+    success &= (counters.Count(mcutils::PerfCounterGroup::kInstructions)==0);
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+
+  std::cout << std::endl;
+  return success;
+}
+
+void ShortDelay()
+{
+  MCUTILS_PROFILE_SCOPE("ShortDelay");
+  volatile float x=0;
+  for (int i=0; i<1000000; ++i) {x+=0.1;};
+}
+
+void Outer(int repetitions)
+{
+  MCUTILS_PROFILE_SCOPE("Outer");
+  for (int i=0; i<repetitions; ++i)
+    {
+      MCUTILS_PROFILE_SCOPE("Inner");
+      ShortDelay();
+    }
+  ShortDelay();
+}
+
+bool TestScopedTimer()
+{
+  // profiling regions
+  std::cout << "ScopedTimer" << std::endl;
+
+  Outer(3);
+  Outer(2);
+  std::thread worker([](){Outer(1);});
+  worker.join();
+
+  mcutils::PrintProfile(std::cout);
+  std::ostringstream json_stream;
+  mcutils::WriteProfileJSON(json_stream);
+  std::cout << json_stream.str();
+
+  // main thread: Outer (2 calls) > Inner (5 calls) > ShortDelay (5 calls),
+  //   and Outer > ShortDelay (2 calls)
+  const mcutils::ThreadProfile& profile = *mcutils::impl::GetProfileRegistry().threads[0];
+  const mcutils::ProfileRegion& outer = profile.regions[profile.regions[0].children[0]];
+  const mcutils::ProfileRegion& inner = profile.regions[outer.children[0]];
+  bool success = (outer.name=="Outer") && (outer.count==2) && (outer.children.size()==2);
+  success &= (inner.name=="Inner") && (inner.count==5);
+  success &= (outer.ExclusiveTime()>=0) && (outer.ExclusiveTime()<outer.InclusiveTime());
+  success &= (inner.MinTime()<=inner.MaxTime()) && (inner.MaxTime()<=outer.MaxTime());
+  success &= (mcutils::impl::GetProfileRegistry().threads.size()==2);
+  success &= (json_stream.str().find("\"name\":\"Inner\",\"calls\":5")!=std::string::npos);
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+
+  std::cout << std::endl;
+  return success;
+}
+
 int main(int argc, char **argv)
 {
 
   TestTimer();
   TestSteadyTimer();
   CompareTimers();
+  bool success = TestCycleTimer();
+  success &= TestPerfCounterGroup();
+  success &= TestScopedTimer();
 
 
   // termination
-  return EXIT_SUCCESS;
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
 }
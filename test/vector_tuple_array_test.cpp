@@ -0,0 +1,85 @@
+/******************************************************************************
+
+  vector_tuple_array_test.cpp
+
+  Created 10/17/26.
+
+******************************************************************************/
+
+#include "mcutils/vector_tuple_array.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+  typedef mcutils::VectorTuple<int,3> tuple_type;
+  typedef mcutils::VectorTupleArray<int,3> array_type;
+  bool success = true;
+
+  ////////////////////////////////////////////////////////////////
+  // element access
+  ////////////////////////////////////////////////////////////////
+
+  array_type a(3);
+  a[0] = tuple_type(1);
+  a[1][0] = 4; a[1][1] = 5; a[1][2] = 6;
+  a[2] = a[0]+2*a[1];
+  tuple_type x = a[2];
+  std::cout << a[0] << " " << a[1] << " " << x << " " << (a[0]<a[1]) << std::endl;
+  success &= (x==tuple_type(std::vector<int>({9,11,13})));
+
+  // 1-based entries
+  mcutils::VectorTupleArray<double,2,1> b(1);
+  b[0][1] = 0.5; b[0][2] = 1.5;
+  b.push_back(b[0]*2.);
+  std::cout << b[1] << " " << b.column(2)[1] << std::endl;
+  success &= (b.size()==2) && (b[1][2]==3.);
+
+  ////////////////////////////////////////////////////////////////
+  // bulk arithmetic
+  ////////////////////////////////////////////////////////////////
+
+  array_type c(a);
+  c += a;
+  c -= tuple_type(1);
+  c *= 3;
+  std::cout << c[0] << " " << c[2] << std::endl;
+  success &= (c[2]==3*(2*a[2]-tuple_type(1)));
+
+  ////////////////////////////////////////////////////////////////
+  // sorting and lookup
+  ////////////////////////////////////////////////////////////////
+
+  // all tuples with entries in 0..4, in scrambled order
+  std::vector<tuple_type> tuples;
+  for (int i=0; i<125; ++i)
+    {
+      int k = (i*37)%125;
+      tuples.push_back(tuple_type(std::vector<int>({k/25,(k/5)%5,k%5})));
+    }
+  array_type d(tuples);
+  success &= (d.ToVector()==tuples);
+
+  d.Sort();
+  std::vector<tuple_type> sorted = tuples;
+  std::sort(sorted.begin(),sorted.end());
+  success &= (d.ToVector()==sorted);
+  std::cout << d[0] << " " << d[1] << " " << d[124] << std::endl;
+
+  bool found = true;
+  for (const tuple_type& t : tuples)
+    found &= (d[d.Find(t)]==t);
+  found &= (d.Find(tuple_type(std::vector<int>({1,5,0})))==d.size());
+  found &= (d.Find(tuple_type(-1))==d.size());
+  std::cout << "lookup " << (found ? "OK" : "MISMATCH") << std::endl;
+  success &= found;
+
+  std::cout << (success ? "PASSED" : "FAILED") << std::endl;
+  std::cout << "****" << std::endl;
+
+  // termination
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
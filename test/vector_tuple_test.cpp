@@ -10,6 +10,12 @@
 ******************************************************************************/
 
 #include "mcutils/vector_tuple.h"
+#include "mcutils/bit_tuple.h"
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <unordered_set>
 
 #include "am/halfint.h"
 
@@ -65,6 +71,130 @@ int main(int argc, char **argv)
   // cout << vc[0] << endl;
 
 
+  // inline storage and compile-time evaluation
+  static_assert(sizeof(mcutils::VectorTuple<int,3>)==3*sizeof(int));
+  constexpr mcutils::VectorTuple<int,3,1> c1(2);
+  constexpr mcutils::VectorTuple<int,3,1> c2 = c1*c1-(-c1);
+  static_assert((c2[1]==6) && (c2[3]==6) && (c2.size()==3));
+  cout << c2 << endl;
+
+  // conversion from vector
+  mcutils::VectorTuple<int,3> z4(std::vector<int>({7,8,9}));
+  cout << z4 << " " << (z4>z1) << (z4<=z1) << endl;
+
+  cout << "****" << endl;
+
+  // expression templates
+  mcutils::VectorTuple<double,4> a(1.), b(2.), c(3.), d(4.);
+  b[3] = 0.5;
+  mcutils::VectorTuple<double,4> e = a+b*c-d;
+  cout << e << " " << (a+b*c-d) << endl;
+  e = 2*a + b/2 - c*0.5;  // scalar broadcast (with int and double scalars)
+  cout << e << endl;
+  e += e*e;  // target appears in expression
+  cout << e << endl;
+  e *= 2;
+  e /= 4.;
+  cout << e << " " << (e==(e*1.)) << (e<e+a) << (e>=-e) << endl;
+  constexpr mcutils::VectorTuple<int,2> c3 = 3*(mcutils::VectorTuple<int,2>(1)+mcutils::VectorTuple<int,2>(2))/2;
+  static_assert(c3[0]==4);
+
+  cout << "****" << endl;
+
+  // reductions and fused multiply-add
+  mcutils::VectorTuple<int,3,1> r1(std::vector<int>({3,-1,4}));
+  mcutils::VectorTuple<int,3,1> r2(std::vector<int>({1,5,9}));
+  cout << Sum(r1) << " " << Dot(r1,r2) << " " << Norm(r1-r1) << " " << Norm(a) << " "
+       << Min(r1) << " " << Max(r1) << " " << Max(r1*r2) << endl;
+  static_assert(mcutils::Sum(mcutils::VectorTuple<int,3>(2))==6);
+  cout << FusedMultiplyAdd(r1,r2,r1) << " " << FusedMultiplyAdd(a,b,c*2.) << endl;
+  cout << Sum(v1+v3) << endl;
+
+  cout << "****" << endl;
+
+  // three-way comparison
+  typedef mcutils::VectorTuple<int,3> Triple;
+  Triple t1(std::vector<int>({1,2,3})), t2(std::vector<int>({1,3,0}));
+  cout << Compare(t1,t2) << Compare(t2,t1) << Compare(t1,t1) << " "
+       << (t1<t2) << (t1<=t2) << (t1>t2) << (t1>=t2) << (t1==t2) << (t1!=t2) << " "
+       << Compare(v1,v3) << Compare(v3,v1) << Compare(v1,v1) << endl;
+  static_assert(mcutils::Compare(Triple(2),Triple(2)+Triple(1))==-1);
+  bool consistent = true;
+  for (int i=0; i<27; ++i)
+    for (int j=0; j<27; ++j)
+      {
+        Triple a(std::vector<int>({i/9,(i/3)%3,i%3})), b(std::vector<int>({j/9,(j/3)%3,j%3}));
+        consistent &= (Compare(a,b)==((i<j)?-1:((i>j)?1:0)));
+        mcutils::VectorTuple<long,6> la(i), lb(j);  // generic (non-fast) path
+        consistent &= (Compare(la,lb)==Compare(a,b)) && ((la<=lb)==(a<=b));
+      }
+  cout << "compare " << (consistent ? "OK" : "MISMATCH") << endl;
+
+  cout << "****" << endl;
+
+  // hashing
+  std::unordered_set<Triple> triples;
+  for (int i=0; i<1000; ++i)
+    triples.insert(Triple(std::vector<int>({i%10,(i/10)%10,i/100})));
+  triples.insert(t1);
+  cout << triples.size() << " " << triples.count(t1) << " "
+       << (std::hash<Triple>()(t1)!=std::hash<Triple>()(t2)) << " "
+       << (hash_value(Triple(0))!=hash_value(Triple(std::vector<int>({0,0,1})))) << endl;
+
+  // explicit evaluation, for storage in auto variable
+  auto evaluated = (t1+t2).Eval();
+  static_assert(std::is_same_v<decltype(evaluated),Triple>);
+  cout << "eval " << (evaluated==Triple(t1+t2)) << endl;
+
+  // packing
+  mcutils::VectorTuplePacker<int,3> packer(Triple(std::vector<int>({0,-5,-20})),Triple(std::vector<int>({10,5,20})));
+  bool packing_ok = (packer.bits()==4+4+6);
+  std::uint64_t previous_key = 0;
+  for (int a=0; a<=10; ++a)
+    for (int b=-5; b<=5; ++b)
+      for (int c=-20; c<=20; ++c)
+        {
+          Triple x(std::vector<int>({a,b,c}));
+          std::uint64_t key = packer.Pack(x);
+          packing_ok &= packer.InRange(x) && (packer.Unpack(key)==x) && ((key>previous_key) || (a+b+c==-25));
+          previous_key = key;
+        }
+  packing_ok &= !packer.InRange(Triple(std::vector<int>({0,6,0})));
+  cout << "packing " << packer.bits() << " bits " << (packing_ok ? "OK" : "MISMATCH") << endl;
+
+  // packing with one entry filling the whole key (the other has zero width)
+  typedef mcutils::VectorTuple<std::int64_t,2> Wide;
+  const std::int64_t wide_min = std::numeric_limits<std::int64_t>::min();
+  const std::int64_t wide_max = std::numeric_limits<std::int64_t>::max();
+  mcutils::VectorTuplePacker<std::int64_t,2> wide_packer(
+      Wide(std::vector<std::int64_t>({7,wide_min})),Wide(std::vector<std::int64_t>({7,wide_max}))
+    );
+  bool wide_packing_ok = (wide_packer.bits()==64);
+  for (std::int64_t y : {wide_min,std::int64_t(-1),std::int64_t(0),wide_max})
+    {
+      Wide x(std::vector<std::int64_t>({7,y}));
+      wide_packing_ok &= (wide_packer.Unpack(wide_packer.Pack(x))==x);
+    }
+  wide_packing_ok &= (wide_packer.Pack(Wide(std::vector<std::int64_t>({7,wide_max})))==~std::uint64_t(0));
+  cout << "wide packing " << wide_packer.bits() << " bits " << (wide_packing_ok ? "OK" : "MISMATCH") << endl;
+
+  // conversion to and from bit_tuple
+  typedef mcutils::bit_tuple<std::uint64_t,8,8,40> label_type;
+  label_type label = mcutils::ToBitTuple<label_type>(Triple(std::vector<int>({3,200,70000})));
+  Triple from_label = mcutils::FromBitTuple<int,3>(label);
+  cout << from_label << " " << int(mcutils::get<1>(label)) << " "
+       << (label==label_type(std::uint64_t(3),std::uint64_t(200),std::uint64_t(70000))) << endl;
+
+  // bit_tuple with single field filling the storage word
+  typedef mcutils::bit_tuple<std::uint64_t,64> word_type;
+  typedef mcutils::VectorTuple<std::uint64_t,1> Single;
+  const Single all_ones(~std::uint64_t(0));
+  word_type word = mcutils::ToBitTuple<word_type>(all_ones);
+  cout << "word " << (word.bitrep()==~std::uint64_t(0)) << " "
+       << (mcutils::FromBitTuple<std::uint64_t,1>(word)==all_ones) << endl;
+
+  cout << "****" << endl;
+
   // termination
   return 0;
 }